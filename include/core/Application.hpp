@@ -4,8 +4,12 @@
 #include <atomic>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 #include <filesystem>
 #include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <glib.h>
 #include <gst/gst.h>
 
@@ -15,6 +19,8 @@
 
 #include "utils/Singleton.hpp"
 #include "video/EventRecorder.hpp"
+#include "video/MetadataExtractor.hpp"
+#include "video/RateGovernor.hpp"
 #include "network/WebSocketClient.hpp"
 #include "network/MessageHandler.hpp"
 #include "monitoring/ThermalMonitor.hpp"
@@ -133,6 +139,7 @@ private:
     void restartRecording();
     void startRecordingForCamera(int cameraIndex, const std::string& filename);
     void stopRecordingForCamera(int cameraIndex);
+    void stopAllRecordings();
     void scheduleNextMidnightRestart();
 
     // 이벤트 핸들러
@@ -144,6 +151,7 @@ private:
     void onSystemAlert(const std::string& alert);
     void onThermalAlert(int objectId, float temperature);
     void onConfigFileChanged(const std::filesystem::path& path);
+    void reconfigurePipeline();
     void onRecordingComplete(const EventRecorder::EventInfo& event, const std::string& filePath);
 
     // 주기적 작업
@@ -161,12 +169,27 @@ private:
 
     // 비디오 처리
     void setupAnalysisProbes();
-    GstPadProbeReturn processVideoFrame(int cameraIndex, GstBuffer* buffer);
+    void setupAnalysisProbe(int cameraIndex);
+    void analyzeFrame(const MetadataExtractor::Frame& frame);
     std::string encodeImageToBase64(const std::string& filePath);
+    std::optional<std::string> snapshotForStatus(int cameraIndex, const std::string& snapshotPath, uint64_t& version);
+    void markSnapshotSent(int cameraIndex, uint64_t version);
     void applyDeviceSettings();
+    void applyAnalysisSettings();
+    void applyRateGovernor();
 
     // 멤버 변수들
     std::atomic<State> state_{State::UNKNOWN};
+    bool inferenceMeta_ = true;  // 분석 프로브에서 DeepStream 배치 메타 사용 여부
+    std::unique_ptr<MetadataExtractor> metadataExtractor_;
+    std::vector<uint64_t> analysisFrameCounts_;  // 카메라별 분석 프레임 수 (메타 추출 워커 스레드 전용)
+    RateGovernor rateGovernor_;                  // heartbeat 스레드 전용
+    std::chrono::steady_clock::time_point lastLatencyLog_;  // heartbeat 스레드 전용
+    
+    // 카메라별 마지막으로 전송한 스냅샷 버전 (heartbeat/연결 스레드에서 접근)
+    std::mutex snapshotMutex_;
+    std::vector<uint64_t> sentSnapshotVersions_;
+    
     std::atomic<bool> running_{false};
     
     // 핵심 컴포넌트들
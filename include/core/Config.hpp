@@ -10,12 +10,48 @@ class Config {
 public:
     // 비디오 설정 구조체
     struct VideoConfig {
+        std::string label;  // peer source 매칭용 이름 (기본값: RGB, Thermal, camN)
         std::string src;
         std::string record;
         std::string infer;
         std::string enc;
         std::string enc2;
         std::string snapshot;
+        
+        // 캡처 버퍼 협상 (src 첫 엘리먼트 기준, 비우거나 0이면 기본값 유지)
+        std::string ioMode;       // v4l2src io-mode: auto | mmap | userptr | dmabuf | dmabuf-import
+        int poolMinBuffers = 0;   // 캡처 버퍼 풀 최소/최대 버퍼 수 (하류 요구량보다 작게는 설정하지 않음)
+        int poolMaxBuffers = 0;
+    };
+
+    // 프레임레이트 상한 (0 = 제한 없음)
+    struct RateConfig {
+        int sourceFps = 0;      // 소스 tee 입력 (모든 브랜치 공통)
+        int inferFps = 0;       // 추론 (nvinfer interval로 환산)
+        int encoderFps = 0;     // 라이브 인코더 입력 (enc/enc2)
+                                // caps 프레임레이트는 그대로이므로 인코더의 bitrate와 키프레임 간격
+                                // (iframeinterval/key-int-max/gop-size)을 통과 비율만큼 보정해 초 단위 값 유지
+                                // PLAYING 중 바꿀 수 없는 속성은 보정하지 않음 (예: 키프레임 주기가 그만큼 길어짐)
+        
+        bool operator==(const RateConfig& other) const {
+            return sourceFps == other.sourceFps && inferFps == other.inferFps && encoderFps == other.encoderFps;
+        }
+        bool operator!=(const RateConfig& other) const { return !(*this == other); }
+    };
+    
+    // 시청자 수/SoC 온도/이벤트 상태에 따른 프레임레이트 조절 (rate_governor 섹션)
+    struct RateGovernorConfig {
+        bool enabled = false;
+        RateConfig watching;        // peer가 있을 때
+        RateConfig idle;            // peer 없음
+        RateConfig night;           // peer 없음 + 야간 시간대
+        RateConfig event;           // 이벤트 진행 중 하한 (이벤트 녹화/과열 객체 감지 중)
+        RateConfig hot;             // SoC 과열 시 상한 (다른 단계보다 우선)
+        int nightStartHour = 22;    // 시작 시각 == 끝 시각이면 야간 없음
+        int nightEndHour = 6;
+        int hotTempC = 85;
+        int coolTempC = 78;         // 과열 해제 온도
+        int holdSeconds = 30;       // 낮추는 결정은 이 시간 동안 유지될 때만 적용 (높이는 결정은 즉시)
     };
 
     // WebRTC 설정 구조체
@@ -27,9 +63,32 @@ public:
         int maxStreamCount = 10;
         int streamBasePort = 5000;
         int deviceCnt = 2;
+        std::string streamTransport = "udp";  // udp | appsink | shared
+        bool egressBufferLists = false;  // RTP 패킷을 버퍼 리스트 단위로 peer 싱크까지 전달 (appsink 리스트 수신, GOP 캐시 일괄 전달)
+        bool encodeOnce = false;  // 녹화/라이브가 메인 인코더 출력을 공유
+        bool lazyEncoderActivation = false;  // 시청자가 없으면 라이브 인코더 정지
+        int gopCacheMaxAgeMs = 1000;  // 이보다 오래된 GOP 캐시는 키프레임 강제 요청
+        bool latencyTracing = false;  // 캡처 -> 송출 지점별 지연 분포 수집
+        bool sharedScaler = false;    // 같은 해상도의 infer/enc2/snapshot 스케일을 카메라당 한 번만 수행
+        bool cachedClockOverlay = false;  // src의 clockoverlay 텍스트를 초당 한 번만 렌더링하고 매 프레임은 합성만
+        int stallTimeoutMs = 0;           // 브랜치 출력이 이 시간 동안 없으면 해당 브랜치만 재구성 (0 = 감시 안 함)
+        int stallRecoveryAttempts = 3;    // 연속 복구 실패 시 해당 브랜치 감시 중단
+        bool analysisBypass = false;      // 추론 브랜치 앞 valve와 우회 경로 구성 (analysis_status로 실행 중 분석 ON/OFF)
+        RateGovernorConfig rateGovernor;
+        
+        // 파이프라인 프로파일: jetson (video 브랜치 그대로) | cpu (x264enc/videotestsrc)
+        std::string pipelineProfile = "jetson";
+        std::vector<std::string> cpuSources;  // cpu 프로파일 카메라별 소스 (비우면 videotestsrc)
+        
+        // 동적 스트림 포트 범위 (0이면 streamBasePort+100 ~ +999)
+        int dynamicPortStart = 0;
+        int dynamicPortEnd = 0;
+        std::vector<std::pair<int, int>> reservedPortRanges = {{7000, 7199}};  // 녹화용
         
         // 경로 설정
         std::string snapshotPath = "/home/nvidia/webrtc";
+        std::string snapshotMode = "continuous";  // continuous | on_demand (요청 시에만 프레임을 받아 JPEG 인코딩)
+        int snapshotTtlMs = 2000;                 // on_demand 인코딩 결과 재사용 시간
         std::string recordPath = "/home/nvidia/data";
         std::string deviceSettingPath = "/home/nvidia/webrtc/device_setting.json";
         
@@ -52,8 +111,8 @@ public:
         std::string ttyName = "/dev/ttyTHS0";
         int ttyBaudrate = 38400;
         
-        // 비디오 설정들 (video0, video1)
-        VideoConfig video[2];
+        // 비디오 설정들 (video0 ~ video{deviceCnt-1})
+        std::vector<VideoConfig> video;
     };
 
     // 디바이스 설정 구조체
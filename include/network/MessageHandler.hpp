@@ -15,12 +15,12 @@ public:
     void handleMessage(const std::string& message);
     
     // 메시지 전송 콜백
-    using SendMessageCallback = std::function<void(const std::string&)>;
+    using SendMessageCallback = std::function<bool(const std::string&)>;  // 전송 실패 시 false
     void setSendMessageCallback(SendMessageCallback cb) { sendCallback_ = cb; }
 
     // 상태 메시지 전송
     void sendRegistration(const std::string& cameraId);
-    void sendCameraStatus(const Signaling::CameraStatusMessage& status);
+    bool sendCameraStatus(const Signaling::CameraStatusMessage& status);
     void sendOffer(const std::string& peerId, const std::string& sdp);
     void sendIceCandidate(const std::string& peerId, const std::string& candidate, int mlineIndex);
 
@@ -21,8 +21,9 @@ struct CameraStatusMessage {
     int recordUsage;
     int cpuTemp;
     int gpuTemp;
-    std::string rgbSnapshot;
-    std::string thermalSnapshot;
+    // 이전 전송 이후 바뀌지 않은 스냅샷은 nullopt (메시지에서 생략)
+    std::optional<std::string> rgbSnapshot;
+    std::optional<std::string> thermalSnapshot;
 };
 
 struct PeerJoinedMessage {
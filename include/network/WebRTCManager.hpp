@@ -57,6 +57,7 @@ private:
         std::unique_ptr<WebRTCPeer> peer;
         PeerInfo info;
         GstElement* udpSrc = nullptr;
+        GstElement* appSrc = nullptr;  // APPSINK 전달 방식 (peer 파이프라인 소유)
         int streamPort = -1;
     };
 
@@ -67,7 +68,10 @@ private:
 
     // 내부 헬퍼 함수들
     bool createPeerConnection(const std::string& peerId, const std::string& source);
+    bool createInProcessConnection(PeerContext* context);
+    bool createSharedConnection(PeerContext* context);
     void setupPeerCallbacks(PeerContext* context);
+    void releasePeer(const std::string& peerId, PeerContext& context);
     CameraDevice parseSource(const std::string& source) const;
     StreamType parseStreamType(const std::string& source) const;
     void logConnectionStats() const;
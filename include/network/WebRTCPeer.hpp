@@ -32,6 +32,8 @@ public:
     using OfferCreatedCallback = std::function<void(const std::string& sdp)>;
     using StateChangeCallback = std::function<void(State oldState, State newState)>;
     using ErrorCallback = std::function<void(const std::string& error)>;
+    // ICE/DTLS 연결 완료 (미디어 전송 가능) 시점
+    using MediaReadyCallback = std::function<void()>;
 
     WebRTCPeer(const Config& config);
     ~WebRTCPeer();
@@ -43,6 +45,12 @@ public:
 
     // 스트림 연결
     bool connectToStream(GstElement* udpSrc);
+    // 이미 RTP 페이로드된 스트림(appsrc 등)을 webrtcbin에 직접 연결
+    bool connectToRtpStream(GstElement* rtpSrc);
+    // 공유 파이프라인 모드: webrtcbin을 담은 bin 생성 (ghost "sink" pad, RTP 입력)
+    // 메인 Pipeline에 연결된 후 startNegotiation() 호출
+    GstElement* createSharedBin();
+    void startNegotiation();
     void disconnect();
 
     // 콜백 설정
@@ -50,6 +58,7 @@ public:
     void setOfferCreatedCallback(OfferCreatedCallback cb) { offerCreatedCallback_ = cb; }
     void setStateChangeCallback(StateChangeCallback cb) { stateChangeCallback_ = cb; }
     void setErrorCallback(ErrorCallback cb) { errorCallback_ = cb; }
+    void setMediaReadyCallback(MediaReadyCallback cb) { mediaReadyCallback_ = cb; }
 
     // 상태 조회
     State getState() const { return state_; }
@@ -81,6 +90,11 @@ private:
     OfferCreatedCallback offerCreatedCallback_;
     StateChangeCallback stateChangeCallback_;
     ErrorCallback errorCallback_;
+    MediaReadyCallback mediaReadyCallback_;
     
     void setState(State newState);
+    bool createWebRTCBin();
+    bool makeWebRTCBin();
+    void connectSignals();
+    bool linkAndStart(GstElement* rtpSource);
 };
\ No newline at end of file
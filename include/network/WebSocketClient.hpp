@@ -25,8 +25,8 @@ public:
     void disconnect();
     bool isConnected() const;
 
-    // 메시지 전송
-    void sendText(const std::string& message);
+    // 메시지 전송 (sendText: 연결되어 있지 않으면 false)
+    bool sendText(const std::string& message);
     void sendBinary(const std::vector<uint8_t>& data);
 
 private:
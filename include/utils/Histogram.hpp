@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free 로그-선형 히스토그램 (마이크로초 등 정수 값)
+// 기록은 relaxed atomic 증가만 수행하므로 스트리밍 스레드에서 호출해도 안전
+// 각 2배 구간을 8개 하위 구간으로 나눔 (상대 오차 약 12% 이내)
+class Histogram {
+public:
+    struct Summary {
+        uint64_t count = 0;
+        double mean = 0.0;
+        uint64_t p50 = 0;
+        uint64_t p95 = 0;
+        uint64_t p99 = 0;
+        uint64_t max = 0;
+    };
+
+    void record(uint64_t value) {
+        buckets_[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t prev = max_.load(std::memory_order_relaxed);
+        while (value > prev && !max_.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    // p: 0.0 ~ 1.0, 해당 구간의 상한값 반환
+    uint64_t percentile(double p) const {
+        std::array<uint64_t, kBucketCount> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        return percentileOf(counts, total, p);
+    }
+
+    Summary summarize() const {
+        std::array<uint64_t, kBucketCount> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        Summary summary;
+        summary.count = total;
+        if (total == 0) {
+            return summary;
+        }
+
+        summary.mean = static_cast<double>(sum_.load(std::memory_order_relaxed)) /
+                       static_cast<double>(count_.load(std::memory_order_relaxed));
+        summary.p50 = percentileOf(counts, total, 0.50);
+        summary.p95 = percentileOf(counts, total, 0.95);
+        summary.p99 = percentileOf(counts, total, 0.99);
+        summary.max = max_.load(std::memory_order_relaxed);
+        return summary;
+    }
+
+    void reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int kSubBits = 3;
+    static constexpr uint64_t kLinearLimit = 16;  // 0~15는 정확한 값으로 기록
+    static constexpr int kMaxMsb = 40;            // 약 12.7일 (마이크로초 기준), 초과 값은 마지막 구간
+    static constexpr size_t kBucketCount = kLinearLimit + (kMaxMsb - 3) * (1 << kSubBits);
+
+    static size_t bucketOf(uint64_t value) {
+        if (value < kLinearLimit) {
+            return static_cast<size_t>(value);
+        }
+
+        int msb = 63 - __builtin_clzll(value);
+        if (msb > kMaxMsb) {
+            return kBucketCount - 1;
+        }
+
+        int shift = msb - kSubBits;
+        size_t sub = static_cast<size_t>((value >> shift) & ((1 << kSubBits) - 1));
+        return kLinearLimit + static_cast<size_t>(msb - 4) * (1 << kSubBits) + sub;
+    }
+
+    static uint64_t upperBoundOf(size_t index) {
+        if (index < kLinearLimit) {
+            return index;
+        }
+
+        size_t octave = (index - kLinearLimit) >> kSubBits;
+        size_t sub = (index - kLinearLimit) & ((1 << kSubBits) - 1);
+        int shift = static_cast<int>(octave) + 4 - kSubBits;
+        return (((1ULL << kSubBits) + sub + 1) << shift) - 1;
+    }
+
+    static uint64_t percentileOf(const std::array<uint64_t, kBucketCount>& counts, uint64_t total, double p) {
+        if (total == 0) {
+            return 0;
+        }
+
+        uint64_t target = static_cast<uint64_t>(p * static_cast<double>(total));
+        if (target >= total) target = total - 1;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            seen += counts[i];
+            if (seen > target) {
+                return upperBoundOf(i);
+            }
+        }
+        return upperBoundOf(kBucketCount - 1);
+    }
+
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+// 고정 크기 lock-free 큐 (다중 생산자 / 단일 소비자)
+// 칸마다 시퀀스 번호를 두어 생산자끼리는 CAS로 자리만 예약하고, 소비자는 잠금 없이 꺼냄
+// 가득 차면 tryPush가 false를 반환 (생산자를 막지 않음)
+template<typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask_ = size - 1;
+        cells_ = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    bool tryPush(T value) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 가득 참
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 소비자 스레드 전용
+    std::optional<T> tryPop() {
+        Cell& cell = cells_[dequeuePos_ & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+            return std::nullopt;
+        }
+        T value = std::move(cell.value);
+        cell.sequence.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+        dequeuePos_++;
+        return value;
+    }
+
+    // 소비자 스레드 전용 (생산자가 예약만 하고 아직 쓰지 않은 칸은 비어 있는 것으로 봄)
+    bool empty() const {
+        return cells_[dequeuePos_ & mask_].sequence.load(std::memory_order_acquire) != dequeuePos_ + 1;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> enqueuePos_{0};
+    alignas(64) size_t dequeuePos_ = 0;
+};
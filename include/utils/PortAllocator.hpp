@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// 동적 스트림용 포트 할당기
+// 범위 [firstPort, lastPort]를 step 간격의 슬롯으로 나누고
+// FIFO 프리 리스트 + 슬롯 상태 배열로 O(1) 할당/해제
+class PortAllocator {
+public:
+    struct Occupancy {
+        size_t used = 0;
+        size_t reserved = 0;
+        size_t capacity = 0;  // 예약 제외 할당 가능한 전체 슬롯 수
+    };
+
+    PortAllocator(int firstPort, int lastPort, int step = 2);
+
+    // 예약 범위 지정 (범위 밖 포트는 무시, 이미 할당된 포트는 해제 시 예약으로 전환)
+    void reserve(int firstPort, int lastPort);
+    // 예약 해제 (해제된 포트는 마지막에 재사용, 할당 중인 포트는 대기 중인 예약만 취소)
+    void unreserve(int firstPort, int lastPort);
+
+    // 할당 실패 시 -1
+    int allocate();
+    bool release(int port);
+    bool isAllocated(int port) const;
+
+    Occupancy getOccupancy() const;
+    int getFirstPort() const { return firstPort_; }
+    int getLastPort() const { return lastPort_; }
+
+private:
+    enum class SlotState : uint8_t {
+        FREE,
+        USED,
+        RESERVED
+    };
+
+    // 포트 -> 슬롯 인덱스 (범위 밖이거나 step에 맞지 않으면 -1)
+    int slotOf(int port) const;
+
+    const int firstPort_;
+    const int lastPort_;
+    const int step_;
+
+    mutable std::mutex mutex_;
+    std::vector<SlotState> slots_;
+    std::vector<bool> pendingReserve_;  // 사용 중에 예약된 슬롯
+    std::deque<int> freeList_;          // 최근 해제된 포트는 가장 나중에 재사용
+    size_t used_ = 0;
+    size_t reserved_ = 0;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// 고정 크기 lock-free 링 (단일 생산자 / 단일 소비자)
+// 칸을 미리 할당해 두고 생산자는 빈 칸에 직접 쓴 뒤 publish, 소비자는 칸을 직접 읽은 뒤 release
+// (큰 POD 레코드를 복사/할당 없이 넘기기 위한 용도)
+template<typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask_ = size - 1;
+        slots_ = std::make_unique<T[]>(size);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // 생산자: 쓸 칸 (가득 차면 nullptr, 같은 칸을 publish 전까지 반복 반환)
+    T* acquire() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) > mask_) {
+            return nullptr;
+        }
+        return &slots_[head & mask_];
+    }
+
+    // 생산자: acquire한 칸을 소비자에게 공개
+    void publish() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 소비자: 가장 오래된 칸 (비어 있으면 nullptr)
+    const T* front() const {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots_[tail & mask_];
+    }
+
+    // 소비자: front 칸을 생산자에게 반환
+    void release() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool empty() const {
+        return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::unique_ptr<T[]> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0};   // 생산자만 증가
+    alignas(64) std::atomic<size_t> tail_{0};   // 소비자만 증가
+};
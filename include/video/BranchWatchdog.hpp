@@ -0,0 +1,95 @@
+#pragma once
+
+#include <gst/gst.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 카메라 브랜치 정지 감시기
+// 브랜치 입력/출력 패드의 마지막 버퍼 시각을 프로브로 기록하고, 출력이 timeout 동안 없으면 복구 콜백 호출
+// 입력도 멈춘 브랜치는 상류(다른 브랜치나 소스) 정지의 피해자이므로, 입력 큐가 가득 찬 경우에만 원인으로 판단
+class BranchWatchdog {
+public:
+    struct Target {
+        std::string name;   // 예: cam0.infer, cam1.enc
+        int camera;
+        int branch;         // 호출 측 브랜치 종류 (Pipeline::Impl::Branch)
+    };
+
+    struct StallEvent {
+        std::string name;
+        int camera = 0;
+        int64_t stalledMs = 0;      // 마지막 출력 이후 경과 시간
+        bool recovered = false;
+        double recoveryMs = 0.0;
+        uint64_t recoveries = 0;    // 누적 복구 성공 횟수
+        bool suspended = false;     // 연속 실패로 감시 중단 (재시작 필요)
+    };
+
+    struct Health {
+        std::string name;
+        int64_t outputAgeMs = -1;   // -1 = 아직 출력 없음
+        int64_t inputAgeMs = -1;
+        uint64_t stalls = 0;
+        uint64_t recoveries = 0;
+        uint64_t failures = 0;
+        bool suspended = false;
+    };
+
+    using Predicate = std::function<bool(const Target&)>;
+    using EventCallback = std::function<void(const StallEvent&)>;
+
+    struct Callbacks {
+        Predicate expectsOutput;    // 지금 출력이 있어야 하는지 (valve로 막힌 브랜치는 false)
+        Predicate isBacklogged;     // 브랜치 입력 큐가 가득 차 상류를 막고 있는지
+        Predicate recover;          // 브랜치 재구성 (감시 스레드에서 호출, 블로킹 허용)
+        EventCallback onStall;
+    };
+
+    BranchWatchdog(std::chrono::milliseconds timeout, int maxAttempts);
+    ~BranchWatchdog();
+
+    BranchWatchdog(const BranchWatchdog&) = delete;
+    BranchWatchdog& operator=(const BranchWatchdog&) = delete;
+
+    int addTarget(const Target& target);
+    // 프로브 설치 (다시 호출하면 이전 패드의 프로브를 교체, 재구성 후 출력 패드 갱신용)
+    void attachInput(int id, GstPad* pad);
+    void attachOutput(int id, GstPad* pad);
+
+    void start(Callbacks callbacks);
+    void stop();
+
+    std::vector<Health> getHealth() const;
+
+private:
+    struct Watch;
+    struct Probe {
+        GstPad* pad = nullptr;
+        gulong id = 0;
+    };
+
+    static GstPadProbeReturn bufferProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    static void attach(Probe& probe, GstPad* pad, std::atomic<int64_t>* lastUs);
+    static void detach(Probe& probe);
+    void run();
+    void check(Watch& watch, int64_t nowUs);
+
+    const std::chrono::milliseconds timeout_;
+    const int maxAttempts_;
+    Callbacks callbacks_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Watch>> watches_;
+
+    std::mutex runMutex_;
+    std::condition_variable wake_;
+    bool running_ = false;
+    std::thread thread_;
+};
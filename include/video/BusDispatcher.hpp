@@ -0,0 +1,91 @@
+#pragma once
+
+#include "utils/MpscQueue.hpp"
+#include <gst/gst.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+// 메인 Pipeline과 모든 peer 파이프라인의 버스 메시지를 한 스레드에서 처리하는 디스패처
+// 버스마다 sync handler를 설치해 메시지를 게시한 스레드에서 바로 받고, 필요한 종류만 큐에 넣음
+// (GLib main loop에 버스 소스를 만들지 않으며, 버스 큐에도 쌓지 않음)
+// 메시지는 게시한 엘리먼트에서 부모 방향으로 가장 가까운 소유자(owner)의 핸들러로 전달
+// 소유자 mask에 없는 종류는 그 위 소유자에게 넘김 (예: peer bin의 LATENCY -> 메인 Pipeline)
+class BusDispatcher {
+public:
+    using Handler = std::function<void(GstMessage* message)>;
+
+    struct Stats {
+        uint64_t posted = 0;        // sync handler가 받은 메시지
+        uint64_t filtered = 0;      // 게시 스레드에서 버린 메시지 (mask 밖, 하위 엘리먼트 STATE_CHANGED)
+        uint64_t dropped = 0;       // 큐가 가득 차 버린 메시지
+        uint64_t dispatched = 0;    // 핸들러에 전달된 메시지
+        uint64_t unrouted = 0;      // 소유자가 이미 해제된 메시지
+    };
+
+    static BusDispatcher& getInstance() {
+        static BusDispatcher instance;
+        return instance;
+    }
+
+    // owner가 파이프라인이면 그 버스에 sync handler 설치, bin이면 상위 파이프라인 버스의 라우팅 대상으로만 등록
+    // STATE_CHANGED는 owner 자신이 게시한 것만 전달 (하위 엘리먼트 상태 변경은 게시 스레드에서 버림)
+    // 반환값 0 = 실패
+    uint32_t attach(GstElement* owner, GstMessageType mask, Handler handler);
+    // 반환 후에는 핸들러가 호출되지 않음 (핸들러 안에서 호출하면 대기하지 않음)
+    void detach(uint32_t id);
+
+    Stats getStats() const;
+
+private:
+    struct Owner {
+        GstElement* element = nullptr;
+        GstBus* bus = nullptr;          // sync handler를 설치한 버스 (bin 소유자는 nullptr)
+        GstMessageType mask = GST_MESSAGE_UNKNOWN;
+        Handler handler;
+    };
+
+    // 큐 항목: 메시지 참조와 수신한 버스의 소유자만 기록 (라우팅은 소비 스레드에서)
+    struct Event {
+        GstMessage* message = nullptr;
+        uint32_t busOwner = 0;
+    };
+
+    BusDispatcher();
+    ~BusDispatcher();
+
+    BusDispatcher(const BusDispatcher&) = delete;
+    BusDispatcher& operator=(const BusDispatcher&) = delete;
+
+    static GstBusSyncReply syncHandler(GstBus* bus, GstMessage* message, gpointer userData);
+    void post(GstMessage* message, uint32_t busOwner);
+    void run();
+    void dispatch(const Event& event);
+    uint32_t resolveOwner(GstObject* source, GstMessageType type, uint32_t busOwner);
+
+    MpscQueue<Event> queue_;
+    GQuark ownerQuark_;
+    std::atomic<unsigned int> acceptMask_{0};  // 등록된 소유자 mask 합집합
+
+    std::atomic<uint64_t> posted_{0};
+    std::atomic<uint64_t> filtered_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> dispatched_{0};
+    std::atomic<uint64_t> unrouted_{0};
+
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;      // detach가 실행 중인 핸들러 종료를 기다림
+    std::map<uint32_t, Owner> owners_;
+    uint32_t nextId_ = 1;
+    uint32_t running_ = 0;              // 현재 핸들러 실행 중인 소유자
+
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> sleeping_{false};
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
@@ -56,6 +56,8 @@ public:
     // 상태 조회
     bool isRecording(int cameraIndex) const;
     size_t getActiveRecordingCount() const;
+    // 수동 녹화가 아닌 이벤트의 녹화 구간이 진행 중인지
+    bool hasActiveEvent() const;
     std::vector<EventInfo> getRecentEvents(size_t count = 10) const;
 
     // 콜백
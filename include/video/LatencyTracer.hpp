@@ -0,0 +1,57 @@
+#pragma once
+
+#include "utils/Histogram.hpp"
+#include <gst/gst.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 캡처 시점부터 각 측정 지점까지의 지연 추적기
+// 캡처 지점에서 버퍼에 CaptureTimeMeta를 붙이고, 측정 지점 프로브에서 (현재 - 캡처) 시간을 기록
+// nvstreammux처럼 메타를 잃는 구간은 소스 tee에서 남긴 PTS -> 캡처 시각 타임라인으로 대체
+class LatencyTracer {
+public:
+    struct PointReport {
+        std::string name;               // 예: cam0.main.encoder, cam0.main.peer.<id>
+        Histogram::Summary latencyUs;
+        uint64_t unmatched = 0;         // 캡처 시각을 찾지 못한 버퍼
+    };
+
+    explicit LatencyTracer(int cameras);
+    ~LatencyTracer();
+
+    LatencyTracer(const LatencyTracer&) = delete;
+    LatencyTracer& operator=(const LatencyTracer&) = delete;
+
+    // 캡처 시각 기록 지점 (보통 카메라 소스 엘리먼트의 src 패드)
+    bool addCapturePoint(GstPad* pad, int camera);
+
+    // 측정 지점. recordsTimeline이면 이 지점의 PTS로 카메라 타임라인을 기록 (카메라당 한 곳)
+    bool addMeasurePoint(GstPad* pad, int camera, const std::string& name, bool recordsTimeline = false);
+    // pad를 주면 그 패드를 측정 중인 지점만 제거 (같은 이름으로 다시 추가된 지점은 유지)
+    void removePoint(const std::string& name, GstPad* pad = nullptr);
+
+    // 모든 프로브 제거 (파이프라인 정지 전 호출)
+    void detachAll();
+
+    std::vector<PointReport> getReport() const;
+    void reset();
+
+private:
+    struct CameraTimeline;
+    struct Point;
+
+    static GstPadProbeReturn captureProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    static GstPadProbeReturn measureProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    static void detachPoint(Point& point);
+
+    std::vector<std::unique_ptr<CameraTimeline>> timelines_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Point>> points_;
+    std::vector<std::shared_ptr<Point>> capturePoints_;
+};
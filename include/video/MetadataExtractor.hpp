@@ -0,0 +1,95 @@
+#pragma once
+
+#include "utils/SpscRing.hpp"
+#include <gst/gst.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// 추론 결과 메타 추출기
+// OSD sink 패드 프로브에서 DeepStream 배치 메타의 필요한 필드만 미리 할당된 POD 레코드로 복사하고,
+// 카메라별 SPSC 링으로 분석 워커 스레드에 넘김 (스트리밍 스레드는 분석 코드를 기다리지 않음)
+// 링이 가득 차면 레코드를 버리고 프레임은 그대로 통과시킴
+class MetadataExtractor {
+public:
+    static constexpr size_t kMaxObjects = 64;       // 프레임당 복사하는 최대 객체 수
+    static constexpr size_t kQueueFrames = 32;      // 카메라별 링 크기 (분석 지연 허용량, 30fps 기준 약 1초)
+    static constexpr uint64_t kUntracked = UINT64_MAX;
+
+    struct Object {
+        float left;
+        float top;
+        float width;
+        float height;
+        float confidence;
+        int32_t classId;
+        uint64_t trackId;           // kUntracked = 추적기 없음
+    };
+
+    struct Frame {
+        int32_t camera;
+        uint32_t objectCount;
+        uint32_t truncated;         // kMaxObjects를 넘어 버린 객체 수
+        uint64_t pts;               // GstClockTime
+        uint64_t frameNumber;
+        Object objects[kMaxObjects];
+    };
+    static_assert(std::is_trivially_copyable<Frame>::value, "Frame must stay POD");
+
+    struct Stats {
+        uint64_t frames = 0;        // 워커에 전달된 프레임
+        uint64_t objects = 0;
+        uint64_t overruns = 0;      // 링이 가득 차 버린 프레임
+        uint64_t truncated = 0;
+        uint64_t missingMeta = 0;   // 배치 메타가 없던 버퍼 (프레임은 통과)
+    };
+
+    using FrameCallback = std::function<void(const Frame& frame)>;
+
+    // batchMeta: 파이프라인이 DeepStream 배치 메타를 붙이는지 (cpu 프로파일은 프레임 PTS만 전달)
+    MetadataExtractor(int cameras, bool batchMeta);
+    ~MetadataExtractor();
+
+    MetadataExtractor(const MetadataExtractor&) = delete;
+    MetadataExtractor& operator=(const MetadataExtractor&) = delete;
+
+    // 프로브 설치 (다시 호출하면 이전 패드의 프로브를 교체, 추론 브랜치 재구성 후 새 OSD로 이동)
+    bool attach(int camera, GstElement* element, const char* padName = "sink");
+
+    // interval개 프레임을 건너뛰고 한 프레임만 복사 (nvinfer가 없는 분석 스텁의 추론 간격, 0 = 매 프레임)
+    void setInterval(int camera, int interval);
+
+    // 콜백은 워커 스레드에서 호출
+    void start(FrameCallback callback);
+    void stop();
+
+    Stats getStats(int camera) const;
+
+private:
+    struct Camera;
+
+    static GstPadProbeReturn bufferProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    void extract(Camera& camera, GstBuffer* buffer);
+    Frame* acquire(Camera& camera);
+    void publish(Camera& camera);
+    void detach(Camera& camera);
+    void run();
+
+    const bool batchMeta_;
+    std::vector<std::unique_ptr<Camera>> cameras_;
+    FrameCallback callback_;
+
+    std::mutex probeMutex_;
+
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> sleeping_{false};
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
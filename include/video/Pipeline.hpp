@@ -11,6 +11,9 @@
 #include <gst/gstpad.h>
 #include <thread>
 #include "core/Config.hpp"
+#include "utils/PortAllocator.hpp"
+#include "video/BranchWatchdog.hpp"
+#include "video/SnapshotCache.hpp"
 
 // GStreamer 객체를 위한 커스텀 삭제자
 template<typename T>
@@ -23,18 +26,28 @@ struct GstDeleter {
 template<typename T>
 using GstPtr = std::unique_ptr<T, GstDeleter<T>>;
 
-// 카메라 장치 타입
+// 카메라 장치 (config의 videoN 인덱스, 2 이상은 추가 카메라)
 enum class CameraDevice : int {
     RGB = 0,
     THERMAL = 1
 };
 
+inline CameraDevice cameraDeviceAt(int index) { return static_cast<CameraDevice>(index); }
+inline int cameraIndexOf(CameraDevice device) { return static_cast<int>(device); }
+
 // 스트림 타입
 enum class StreamType : int {
     MAIN = 0,
     SECONDARY = 1
 };
 
+// 동적 스트림 전달 방식
+enum class StreamTransport : int {
+    UDP_LOOPBACK = 0,   // udpsink -> 127.0.0.1 -> udpsrc (기존 방식)
+    APPSINK = 1,        // appsink -> appsrc 프로세스 내부 전달 (버퍼 참조 공유)
+    SHARED_PIPELINE = 2 // peer의 webrtcbin bin을 메인 파이프라인 tee에 직접 연결
+};
+
 class Pipeline {
 public:
     struct PipelineConfig {
@@ -42,7 +55,24 @@ public:
         std::string snapshotPath = "/tmp/snapshots";
         int maxStreamCount = 10;
         int basePort = 5000;
-        int cameras = 2;
+        int cameras = 2;  // webrtcConfig.video 개수를 넘지 않도록 create()에서 보정
+        StreamTransport transport = StreamTransport::UDP_LOOPBACK;
+    };
+
+    // 새 peer 브랜치의 첫 키프레임 대기 상태 (Pipeline.cpp 내부 정의)
+    struct StreamPrimer;
+    // peer 브랜치 송출 카운터 (스트리밍 스레드에서 lock-free 갱신, Pipeline.cpp 내부 정의)
+    struct StreamMetrics;
+
+    // peer별 송출 통계 스냅샷
+    struct EgressStats {
+        uint64_t bytes = 0;
+        uint64_t buffers = 0;
+        uint64_t sends = 0;             // 싱크 전달 횟수 (udpsink: sendto 또는 리스트당 sendmmsg 한 번)
+        uint64_t lists = 0;             // 그중 버퍼 리스트로 묶여 전달된 횟수
+        uint64_t overruns = 0;          // leaky queue 가득 참 -> 오래된 버퍼 드롭
+        guint queueLevelBuffers = 0;
+        guint64 queueLevelTimeNs = 0;
     };
 
     // 동적 스트림 정보
@@ -54,9 +84,40 @@ public:
         GstPad* teepad = nullptr;  
         GstElement* queue = nullptr;
         GstElement* udpsink = nullptr;
+        GstElement* appsink = nullptr;  // APPSINK 전달 방식에서만 사용
+        GstElement* peerBin = nullptr;  // SHARED_PIPELINE 방식에서만 사용 (peer 소유)
+        std::shared_ptr<StreamPrimer> primer;
+        std::shared_ptr<StreamMetrics> metrics;
+        EgressStats egress;  // getDynamicStreamInfo() 조회 시점 값
         bool active = false;
     };
 
+    // 재구성 대상 브랜치 (name() 예: cam0.enc, cam1.infer)
+    struct BranchRef {
+        int camera = 0;
+        std::string branch;  // record, infer, enc, enc2, snapshot
+        
+        std::string name() const { return "cam" + std::to_string(camera) + "." + branch; }
+    };
+    
+    // 부분 재구성 결과
+    struct ReconfigureResult {
+        std::vector<BranchRef> rebuilt;
+        std::vector<BranchRef> failed;
+        bool restartRequired = false;  // 소스/카메라 수/브랜치 구조 변경은 재시작 필요
+    };
+
+    // 카메라별 캡처 버퍼 협상 결과 (첫 버퍼 수신 시 확정)
+    struct CaptureReport {
+        std::string element;        // 캡처 엘리먼트 팩토리 (예: v4l2src)
+        std::string ioMode;         // 적용한 io-mode (비면 엘리먼트 기본값)
+        std::string memory;         // 실제 버퍼 메모리: dmabuf | mmap | system
+        unsigned poolMin = 0;       // 협상된 버퍼 풀 크기
+        unsigned poolMax = 0;       // 0 = 제한 없음
+        size_t bufferSize = 0;
+        bool negotiated = false;
+    };
+
     Pipeline();
     ~Pipeline();
 
@@ -65,14 +126,70 @@ public:
     bool start();
     bool stop();
     bool isRunning() const;
+    std::vector<CaptureReport> getCaptureReports() const;
+    
+    // 브랜치 정지 감시 (stall_timeout_ms 설정 시): 정지 감지/복구 시도마다 감시 스레드에서 호출
+    using StallEvent = BranchWatchdog::StallEvent;
+    using StallCallback = std::function<void(const StallEvent&)>;
+    void setStallCallback(StallCallback callback);
+    std::vector<BranchWatchdog::Health> getBranchHealth() const;
+    
+    // 실행 중 변경된 카메라 브랜치만 교체 (다른 브랜치와 peer 스트림은 유지)
+    ReconfigureResult reconfigure(const Config::WebRTCConfig& webrtcConfig);
+
+    // 분석 ON/OFF (analysis_bypass 설정 시): 끄면 추론 엘리먼트 입력을 막고 원본 프레임을 인코더로 우회
+    // 추론 브랜치가 없는 카메라는 아무것도 하지 않고 true
+    bool setAnalysisEnabled(int cameraIndex, bool enabled);
+    bool isAnalysisEnabled(int cameraIndex) const;
+    // 추론 브랜치 nvinfer의 interval (건너뛸 배치 수) 변경, 브랜치 재구성 후에도 유지
+    // 반환값: 적용한 nvinfer 수 (0 = nvinfer 없음, 예: cpu 프로파일)
+    int setInferenceInterval(int cameraIndex, int interval);
+    // 실제 적용 중인 interval (디바이스 설정과 추론 프레임레이트 상한 중 큰 값, -1 = 설정 파일 값)
+    int getInferenceInterval(int cameraIndex) const;
+
+    // 프레임레이트 상한 (rate_governor, 0 = 제한 없음): caps를 바꾸지 않고 버퍼만 버려 peer 재협상 없이 즉시 적용
+    // 소스는 소스 tee 입력, 인코더는 라이브 인코더 입력, 추론은 nvinfer interval로 환산 (같은 값 반복 호출 가능)
+    // 반환값: interval을 적용한 nvinfer 수
+    using RateLimits = Config::RateConfig;
+    int setRateLimits(int cameraIndex, const RateLimits& limits);
 
     // 엘리먼트 접근
     GstElement* getElement(const std::string& name);
 
-    std::optional<int> addDynamicStream(const std::string& peerId, CameraDevice device, StreamType type);
-    bool removeDynamicStream(const std::string& peerId);
+    // 브랜치 연결/해제 완료 콜백 (스트리밍 또는 정리 스레드에서 호출되므로 블로킹 금지)
+    using CompletionCallback = std::function<void(bool success)>;
+
+    // 포트는 즉시 반환되고 tee 연결/해제는 비동기로 완료됨
+    std::optional<int> addDynamicStream(const std::string& peerId, CameraDevice device, StreamType type,
+                                        CompletionCallback onComplete = nullptr);
+    bool removeDynamicStream(const std::string& peerId, CompletionCallback onComplete = nullptr);
     std::optional<DynamicStreamInfo> getDynamicStreamInfo(const std::string& peerId) const;
     std::vector<std::string> getActivePeerIds() const;
+    PortAllocator::Occupancy getPortOccupancy() const;
+    // 전체 peer 송출 통계 (peerId -> 스냅샷)
+    std::unordered_map<std::string, EgressStats> getEgressStatistics() const;
+    
+    // 프로세스 내부 전달 (APPSINK 모드): peer의 appsrc를 동적 스트림에 연결
+    StreamTransport getTransport() const;
+    bool connectAppSource(const std::string& peerId, GstElement* appsrc);
+    // appsink 콜백 해제 (콜백이 보유한 appsrc 참조도 함께 해제)
+    void disconnectAppSource(const std::string& peerId);
+    
+    // peer 미디어 경로가 준비되면 호출: GOP 캐시로 첫 프레임 즉시 전달
+    bool primeDynamicStream(const std::string& peerId);
+    
+    // 공유 파이프라인 (SHARED_PIPELINE 모드): peer의 webrtcbin bin을 tee 브랜치에 연결
+    bool attachPeerBin(const std::string& peerId, GstElement* peerBin,
+                       CompletionCallback onComplete = nullptr);
+    
+    // 카메라 조회
+    int getCameraCount() const;
+    int getRecordPort(int cameraIndex) const;
+    // peer 요청 source ("RGB", "thermal", 카메라 label, "camN"/"videoN", "N") -> 카메라
+    std::optional<CameraDevice> resolveCamera(const std::string& source) const;
+    
+    // 카메라별 최신 스냅샷 (파이프라인 생성 전에는 nullptr)
+    SnapshotCache* getSnapshotCache() const;
     
     // 동적 스트림 추가/제거
     bool addStream(const std::string& peerId, CameraDevice device, StreamType type);
@@ -95,9 +212,36 @@ public:
         uint64_t bytesProcessed = 0;
         double currentFps = 0.0;
         double averageFps = 0.0;
+        double jitterMs = 0.0;            // 프레임 간격 지터
+        double frameIntervalP99Ms = 0.0;
+        
+        // 소스 tee -> OSD 프레임 처리 시간 (히스토그램 구간 상한값)
+        uint64_t processingSamples = 0;
+        double processingMeanMs = 0.0;
+        double processingP50Ms = 0.0;
+        double processingP95Ms = 0.0;
+        double processingP99Ms = 0.0;
+        double processingMaxMs = 0.0;
+        uint64_t unmatchedFrames = 0;     // 처리 시간을 측정하지 못한 프레임
     };
     
+    // 잠금 없이 읽기 (스트리밍 스레드를 막지 않음)
     Statistics getStatistics(CameraDevice device) const;
+    
+    // 캡처 시점 기준 지점별 지연 분포 (latency_tracing 설정 시)
+    // 지점 이름: camN.source_tee, camN.osd, camN.main.encoder, camN.main.stream_tee, camN.main.peer.<id> ...
+    struct LatencyPoint {
+        std::string name;
+        uint64_t samples = 0;
+        uint64_t unmatched = 0;  // 캡처 시각을 찾지 못한 버퍼
+        double meanMs = 0.0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+    };
+    
+    std::vector<LatencyPoint> getLatencyReport() const;
 
 private:
     struct Impl;
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "core/Config.hpp"
+#include <string>
+#include <vector>
+
+// 파이프라인 프로파일
+// jetson: config.json의 video 브랜치(NVIDIA/DeepStream 엘리먼트) 그대로 사용
+// cpu:    videotestsrc(또는 cpu_sources의 v4l2 loopback) + x264enc + identity 분석 스텁
+//         브랜치 이름(video_src_teeN, nvosd_N, 녹화 포트)은 jetson과 동일하게 유지
+class PipelineProfile {
+public:
+    static bool isSupported(const std::string& profile);
+
+    // 프로파일에 맞게 config.video 브랜치를 치환 (jetson이면 변경 없음)
+    static void apply(Config::WebRTCConfig& config);
+
+    // 분석 프로브가 DeepStream 배치 메타를 기대할 수 있는지
+    static bool providesInferenceMeta(const std::string& profile);
+
+    // 카메라 녹화 포트: 녹화 프로세스 설정을 공유하도록 jetson record 브랜치의 udpsink 포트를 그대로 사용
+    // (Pipeline과 cpu 프로파일이 같은 규칙을 쓰도록 여기서만 해석)
+    static int recordPort(const Config::VideoConfig& video, int cameraIndex);
+
+    // 시작 시 확인할 GStreamer 플러그인 목록
+    static std::vector<std::string> requiredPlugins(const std::string& profile);
+
+private:
+    static Config::VideoConfig cpuVideoConfig(const Config::WebRTCConfig& config, int cameraIndex);
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "core/Config.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+
+// 파이프라인 설정/요청 문자열 해석 (GStreamer 없이 동작하는 순수 함수)
+class PipelineText {
+public:
+    // 브랜치 본문 앞단의 스케일 요구 (공유 스케일러 판단용)
+    struct ScaleSpec {
+        int width = 0;
+        int height = 0;
+        int fpsNum = 0;         // 0이면 원본 프레임레이트 유지
+        int fpsDen = 1;
+        size_t prefixEnd = 0;   // 본문에서 queue/videoscale/videorate/caps 접두부 길이
+    };
+
+    // "queue ! videoscale ! [videorate !] video/x-raw,width=W,height=H[,framerate=N/D] ! ..." 접두부 해석
+    // videoscale과 해상도가 없거나, 접두부 뒤에 남는 엘리먼트가 없거나, 값이 범위를 넘으면 nullopt
+    static std::optional<ScaleSpec> parseScalePrefix(const std::string& body);
+
+    // 음이 아닌 10진 정수 전체 일치 (부호/공백/초과 값은 nullopt)
+    static std::optional<int> parseIndex(const std::string& text);
+
+    // peer 요청 source ("RGB", "thermal", 카메라 label, "camN"/"videoN", "N") -> 카메라 인덱스
+    // 범위 밖 인덱스나 일치하는 label이 없으면 nullopt
+    static std::optional<int> resolveCamera(const std::string& source,
+                                            const std::vector<Config::VideoConfig>& videos, int cameras);
+
+    // 체인에서 videorate 엘리먼트와 caps의 framerate 필드 제거 (요청 시에만 프레임을 받는 on_demand 스냅샷용)
+    // 결과는 " ! "로 다시 연결하며 끝에 링크 기호를 붙이지 않음
+    static std::string stripRateControl(const std::string& chain);
+};
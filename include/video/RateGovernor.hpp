@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core/Config.hpp"
+#include <chrono>
+#include <optional>
+
+// 프레임레이트 정책 결정기
+// 시청자 수, SoC 온도, 이벤트 진행 여부, 시각으로 소스/추론/인코더 프레임레이트 상한을 정함
+// 높이는 결정(시청자 접속, 이벤트 발생)과 과열 진입은 즉시, 낮추는 결정은 hold 시간 동안 유지될 때만 적용
+class RateGovernor {
+public:
+    enum class Mode { WATCHING, IDLE, NIGHT };
+
+    struct Inputs {
+        int peers = 0;
+        int socTempC = 0;
+        bool eventArmed = false;
+        int hour = 0;               // 현지 시각 0~23
+    };
+
+    struct Decision {
+        Config::RateConfig rates;
+        Mode mode = Mode::IDLE;
+        bool event = false;
+        bool hot = false;
+
+        bool operator==(const Decision& other) const {
+            return rates == other.rates && mode == other.mode && event == other.event && hot == other.hot;
+        }
+        bool operator!=(const Decision& other) const { return !(*this == other); }
+    };
+
+    // 적용할 새 결정 (변화 없음/낮추기 대기 중이면 nullopt)
+    std::optional<Decision> update(const Config::RateGovernorConfig& config, const Inputs& inputs,
+                                   std::chrono::steady_clock::time_point now);
+
+    // 마지막으로 적용한 결정 (update() 전에는 nullopt)
+    const std::optional<Decision>& current() const { return current_; }
+
+    // 결정을 버리고 처음 상태로 (조절 비활성화 시)
+    void reset();
+
+    static const char* modeName(Mode mode);
+
+private:
+    Decision evaluate(const Config::RateGovernorConfig& config, const Inputs& inputs);
+    static bool raises(const Config::RateConfig& from, const Config::RateConfig& to);
+
+    std::optional<Decision> current_;
+    std::optional<Decision> pending_;
+    std::chrono::steady_clock::time_point pendingSince_;
+    bool hot_ = false;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <gst/gst.h>
+#include <gst/app/gstappsink.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+// 카메라별 최신 스냅샷 JPEG 캐시 (snapshot 브랜치의 appsink에서 갱신)
+// continuous: 브랜치가 인코딩한 JPEG를 받아 base64를 한 번만 계산, 내용이 같으면 버전 유지
+// on_demand:  브랜치 앞단 valve를 닫아 두고, 조회 시 TTL이 지났으면 다음 원본 프레임 하나만 통과시켜
+//             snapshot 브랜치 스레드에서 인코딩 (조회는 기다리지 않고 그때까지의 스냅샷 반환)
+class SnapshotCache {
+public:
+    struct Snapshot {
+        uint64_t version = 0;                       // 내용이 바뀔 때만 증가 (0 = 없음)
+        std::shared_ptr<const std::string> base64;  // 복사 없이 공유
+        size_t jpegBytes = 0;
+        std::chrono::system_clock::time_point capturedAt;
+    };
+
+    explicit SnapshotCache(int cameras, std::chrono::milliseconds ttl = std::chrono::milliseconds(2000));
+    ~SnapshotCache();
+
+    SnapshotCache(const SnapshotCache&) = delete;
+    SnapshotCache& operator=(const SnapshotCache&) = delete;
+
+    // snapshot 브랜치 appsink에 콜백 연결 (브랜치 재구성 시 새 appsink로 다시 호출)
+    // gate(valve)가 주어지면 on_demand: appsink는 원본 프레임을 받아 콜백에서 인코딩
+    bool attach(GstElement* appsink, int camera, GstElement* gate = nullptr);
+
+    // attach되지 않은 카메라는 파일 싱크 등 사용자 정의 snapshot 브랜치
+    bool isAttached(int camera) const;
+    // on_demand 카메라는 TTL이 지났으면 다음 프레임을 요청만 하고 바로 반환 (새 스냅샷은 다음 조회부터)
+    std::optional<Snapshot> get(int camera);
+    uint64_t getVersion(int camera) const;
+
+private:
+    struct Slot {
+        mutable std::mutex mutex;
+        Snapshot snapshot;
+        size_t digest = 0;
+        std::chrono::steady_clock::time_point encodedAt;
+        std::atomic<uint64_t> version{0};
+        std::atomic<bool> attached{false};
+
+        // on_demand 상태 (mutex 보호)
+        GstElement* gate = nullptr;
+    };
+
+    struct SinkContext {
+        SnapshotCache* cache;
+        int camera;
+    };
+
+    static GstFlowReturn onNewSample(GstAppSink* appsink, gpointer userData);
+    void store(Slot& slot, const guint8* data, size_t size);
+    void encodeRaw(Slot& slot, GstSample* sample);
+
+    std::chrono::milliseconds ttl_;
+    std::vector<std::unique_ptr<Slot>> slots_;
+};
@@ -4,7 +4,6 @@
 #include <string>
 #include <unordered_map>
 #include <mutex>
-#include <set>  // std::set을 위해 추가
 #include "video/Pipeline.hpp"
 
 // 동적 스트림 관리
@@ -38,9 +37,4 @@ private:
     std::shared_ptr<Pipeline> pipeline_;
     mutable std::mutex mutex_;
     std::unordered_map<std::string, StreamConfig> streams_;
-    
-    // 포트 할당 관리
-    std::set<int> usedPorts_;
-    int allocatePort();
-    void releasePort(int port);
 };
\ No newline at end of file
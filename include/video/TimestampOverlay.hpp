@@ -0,0 +1,49 @@
+#pragma once
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <cstdint>
+#include <ctime>
+
+// 초 단위로만 바뀌는 clockoverlay 텍스트를 캐시해서 합성
+// 원래 clockoverlay는 silent로 두고, 같은 속성의 clockoverlay를 별도 렌더러(appsrc ! clockoverlay ! appsink)로
+// 초당 한 번 실행해 GstVideoOverlayComposition 메타를 받아 둔 뒤 매 프레임은 블렌딩만 수행
+// (clockoverlay 내부 블렌딩과 같은 gst_video_overlay_composition_blend 사용 -> 픽셀 동일)
+class TimestampOverlay {
+public:
+    ~TimestampOverlay();
+
+    TimestampOverlay(const TimestampOverlay&) = delete;
+    TimestampOverlay& operator=(const TimestampOverlay&) = delete;
+
+    // clockoverlay src 패드에 캐시 합성 프로브 설치 (프로브가 수명 관리)
+    // 렌더러가 컴포지션 메타를 주지 못하면 원래 clockoverlay 렌더링으로 되돌림
+    static bool install(GstElement* clockOverlay, int camera);
+
+private:
+    TimestampOverlay(GstElement* clockOverlay, int camera);
+
+    static GstPadProbeReturn frameProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    static GstPadProbeReturn allocationProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+
+    void setCaps(GstCaps* caps);
+    bool startRenderer();
+    void stopRenderer();
+    bool render();
+    void fallback();
+
+    GstElement* source_;    // 원래 clockoverlay (silent)
+    int camera_;
+
+    // 렌더러 (스트리밍 스레드에서만 접근)
+    GstElement* renderer_ = nullptr;
+    GstElement* appsrc_ = nullptr;
+    GstElement* appsink_ = nullptr;
+    GstBuffer* canvas_ = nullptr;
+    GstCaps* caps_ = nullptr;
+    GstVideoInfo info_{};
+    GstVideoOverlayComposition* composition_ = nullptr;
+    std::time_t renderedSecond_ = -1;
+    uint64_t renders_ = 0;
+    uint64_t frames_ = 0;
+};
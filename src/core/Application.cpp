@@ -6,6 +6,7 @@
 #include "network/MessageHandler.hpp"
 #include "network/SignalingProtocol.hpp"
 #include "video/Pipeline.hpp"
+#include "video/PipelineProfile.hpp"
 #include "video/EventRecorder.hpp"
 #include "hardware/SerialPort.hpp"
 #include "monitoring/ThermalMonitor.hpp"
@@ -18,10 +19,9 @@
 #include <getopt.h>
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
 #include <sys/wait.h>
 #include <gst/video/video.h>
-#include <nvbufsurface.h>
-#include <gstnvdsmeta.h>
 
 Application::~Application() {
     shutdown();
@@ -222,20 +222,26 @@ bool Application::initializeLogging() {
 bool Application::initializeGStreamer() {
     LOG_INFO("Initializing GStreamer...");
     
-    // CUDA 초기화 (GStreamer보다 먼저)
-    cudaError_t cudaStatus = cudaSetDevice(0);
-    if (cudaStatus != cudaSuccess) {
-        LOG_WARNING("Failed to initialize CUDA: {}", cudaGetErrorString(cudaStatus));
-    } else {
-        LOG_INFO("CUDA initialized successfully");
+    const auto& config = Config::getInstance().getWebRTCConfig();
+    
+#ifdef HAVE_CUDA
+    // CUDA 초기화 (GStreamer보다 먼저, cpu 프로파일은 GPU 미사용)
+    if (config.pipelineProfile != "cpu") {
+        cudaError_t cudaStatus = cudaSetDevice(0);
+        if (cudaStatus != cudaSuccess) {
+            LOG_WARNING("Failed to initialize CUDA: {}", cudaGetErrorString(cudaStatus));
+        } else {
+            LOG_INFO("CUDA initialized successfully");
+            
+            // CUDA 컨텍스트 생성
+            cudaFree(0);
+        }
         
-        // CUDA 컨텍스트 생성
-        cudaFree(0);
+        // 환경 변수 설정 (CUDA 관련)
+        setenv("CUDA_DEVICE_ORDER", "PCI_BUS_ID", 1);
+        setenv("CUDA_VISIBLE_DEVICES", "0", 1);
     }
-    
-    // 환경 변수 설정 (CUDA 관련)
-    setenv("CUDA_DEVICE_ORDER", "PCI_BUS_ID", 1);
-    setenv("CUDA_VISIBLE_DEVICES", "0", 1);
+#endif
     
     GError* error = nullptr;
     if (!gst_init_check(nullptr, nullptr, &error)) {
@@ -245,16 +251,10 @@ bool Application::initializeGStreamer() {
         return false;
     }
     
-    // 필요한 플러그인 확인
-    const char* requiredPlugins[] = {
-        "coreelements", "videoconvert", "videoscale", "videotestsrc",
-        "x264", "vpx", "webrtc", "nice", "dtls", "srtp", "rtpmanager",
-        "nvvideoconvert", "nvv4l2h264enc", "nvstreammux", "nvinfer"
-    };
-    
+    // 필요한 플러그인 확인 (파이프라인 프로파일별)
     GstRegistry* registry = gst_registry_get();
-    for (const auto& pluginName : requiredPlugins) {
-        GstPlugin* plugin = gst_registry_find_plugin(registry, pluginName);
+    for (const auto& pluginName : PipelineProfile::requiredPlugins(config.pipelineProfile)) {
+        GstPlugin* plugin = gst_registry_find_plugin(registry, pluginName.c_str());
         if (!plugin) {
             LOG_WARNING("GStreamer plugin not found: {} (optional)", pluginName);
         } else {
@@ -318,6 +318,25 @@ bool Application::createPipeline() {
     pipelineConfig.maxStreamCount = config.maxStreamCount;
     pipelineConfig.basePort = config.streamBasePort;
     pipelineConfig.webrtcConfig = config;  // 전체 config 전달
+    pipelineConfig.cameras = config.deviceCnt;
+    
+    // 파이프라인 프로파일 적용 (cpu: NVIDIA 엘리먼트 없이 동작하는 브랜치로 치환)
+    PipelineProfile::apply(pipelineConfig.webrtcConfig);
+    inferenceMeta_ = PipelineProfile::providesInferenceMeta(pipelineConfig.webrtcConfig.pipelineProfile);
+    LOG_INFO("Pipeline profile: {}", pipelineConfig.webrtcConfig.pipelineProfile);
+    
+    // 동적 스트림 전달 방식
+    if (config.streamTransport == "appsink") {
+        pipelineConfig.transport = StreamTransport::APPSINK;
+    } else if (config.streamTransport == "shared") {
+        pipelineConfig.transport = StreamTransport::SHARED_PIPELINE;
+    } else {
+        if (config.streamTransport != "udp") {
+            LOG_WARNING("Unknown stream transport '{}', using udp", config.streamTransport);
+        }
+        pipelineConfig.transport = StreamTransport::UDP_LOOPBACK;
+    }
+    LOG_INFO("Dynamic stream transport: {}", config.streamTransport);
     
     // 스냅샷 디렉토리 생성
     std::filesystem::create_directories(config.snapshotPath);
@@ -330,13 +349,28 @@ bool Application::createPipeline() {
     
     // 비디오 분석 프로브 설정
     setupAnalysisProbes();
-    
+
+    // 정지 브랜치 복구 알림 (감시 스레드에서 호출)
+    pipeline_->setStallCallback([this](const Pipeline::StallEvent& event) {
+        if (event.recovered && event.name.size() > 6 &&
+            event.name.compare(event.name.size() - 6, 6, ".infer") == 0) {
+            // 추론 브랜치가 교체되면 분석 프로브도 새 OSD로 이동
+            setupAnalysisProbe(event.camera);
+        }
+        if (event.suspended) {
+            LOG_ERROR("Branch {} could not be recovered - pipeline restart required", event.name);
+        }
+    });
+
     // 파이프라인 시작
     if (!pipeline_->start()) {
         LOG_ERROR("Failed to start pipeline");
         return false;
     }
     
+    // 디바이스 설정의 분석 ON/OFF, 추론 간격 적용
+    applyAnalysisSettings();
+    
     // 녹화 디렉토리 생성
     std::filesystem::create_directories(config.recordPath);
     
@@ -381,9 +415,7 @@ void Application::scheduleNextMidnightRestart() {
         LOG_INFO("Preparing for midnight restart - stopping recordings");
         
         // 모든 녹화 중지
-        for (auto& [camIdx, pid] : recordingPids_) {
-            stopRecordingForCamera(camIdx);
-        }
+        stopAllRecordings();
         
         // 녹화 타이머 중지
         if (recordingTimer_) {
@@ -412,10 +444,11 @@ void Application::restartRecording() {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
     
-    for (int i = 0; i < config.deviceCnt && i < 2; ++i) {
-        // 이전 녹화 종료
-        stopRecordingForCamera(i);
-        
+    // 이전 녹화 종료 (모든 카메라 동시에)
+    stopAllRecordings();
+    
+    int cameras = pipeline_ ? pipeline_->getCameraCount() : 0;
+    for (int i = 0; i < cameras; ++i) {
         std::stringstream filename;
         filename << config.recordPath << "/";
         filename << "cam" << i << "_";
@@ -432,7 +465,7 @@ void Application::startRecordingForCamera(int cameraIndex, const std::string& fi
     const auto& config = Config::getInstance().getWebRTCConfig();
     
     // 녹화 포트 (config의 record 설정에서 지정된 포트)
-    int recordPort = 7000 + cameraIndex;
+    int recordPort = pipeline_ ? pipeline_->getRecordPort(cameraIndex) : 7000 + cameraIndex;
     
     // 녹화 시간 계산 (분 단위를 초로 변환)
     int durationSeconds = config.recordDuration * 60;
@@ -502,6 +535,55 @@ void Application::stopRecordingForCamera(int cameraIndex) {
     }
 }
 
+// 모든 녹화 프로세스에 SIGTERM을 먼저 보내고 하나의 마감 시각까지 함께 대기
+void Application::stopAllRecordings() {
+    if (recordingPids_.empty()) {
+        return;
+    }
+    
+    for (const auto& [camIdx, pid] : recordingPids_) {
+        if (pid > 0) {
+            LOG_INFO("Stopping recording for camera {} (PID: {})", camIdx, pid);
+            kill(pid, SIGTERM);
+        }
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    std::unordered_map<int, pid_t> pending;
+    for (const auto& [camIdx, pid] : recordingPids_) {
+        if (pid > 0) pending[camIdx] = pid;
+    }
+    
+    while (!pending.empty() && std::chrono::steady_clock::now() < deadline) {
+        for (auto it = pending.begin(); it != pending.end();) {
+            int status;
+            pid_t result = ::waitpid(it->second, &status, WNOHANG);
+            if (result == it->second) {
+                LOG_INFO("Recording process {} terminated successfully", it->second);
+                it = pending.erase(it);
+            } else if (result == -1) {
+                LOG_ERROR("waitpid failed for PID {}: {}", it->second, strerror(errno));
+                it = pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (!pending.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+    
+    // 타임아웃 시 SIGKILL
+    for (const auto& [camIdx, pid] : pending) {
+        LOG_WARNING("Recording process {} did not terminate, sending SIGKILL", pid);
+        kill(pid, SIGKILL);
+        int status;
+        ::waitpid(pid, &status, 0);
+    }
+    
+    recordingPids_.clear();
+}
+
 bool Application::setupWebSocket() {
    LOG_INFO("Setting up WebSocket connection...");
    
@@ -537,12 +619,12 @@ bool Application::setupWebSocket() {
    // 메시지 핸들러에 전송 콜백 설정
    messageHandler_->setSendMessageCallback(
        [this](const std::string& msg) {
-           if (wsClient_ && wsClient_->isConnected()) {
-               wsClient_->sendText(msg);
+           if (wsClient_ && wsClient_->isConnected() && wsClient_->sendText(msg)) {
                stats_.messagesSent++;
-           } else {
-               LOG_WARNING("Cannot send message - WebSocket not connected");
+               return true;
            }
+           LOG_WARNING("Cannot send message - WebSocket not connected");
+           return false;
        }
    );
    
@@ -706,11 +788,19 @@ void Application::shutdown() {
     LOG_INFO("Shutting down application");
     setState(State::SHUTTING_DOWN);
     
-    // 1. 모든 녹화 프로세스 먼저 종료
-    for (auto& [camIdx, pid] : recordingPids_) {
-        stopRecordingForCamera(camIdx);
-    }
-    recordingPids_.clear();
+    using Clock = std::chrono::steady_clock;
+    const auto shutdownStart = Clock::now();
+    auto phaseStart = shutdownStart;
+    auto endPhase = [&phaseStart]() {
+        auto now = Clock::now();
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - phaseStart).count();
+        phaseStart = now;
+        return ms;
+    };
+    
+    // 1. 모든 녹화 프로세스 먼저 종료 (병렬)
+    stopAllRecordings();
+    auto recordingsMs = endPhase();
     
     // 2. 타이머 중지
     if (recordingTimer_) {
@@ -737,7 +827,7 @@ void Application::shutdown() {
         wsClient_.reset();
     }
     
-    // 5. WebRTC 연결 정리
+    // 5. WebRTC 연결 정리 (peer별 연결 종료는 병렬)
     if (webrtcManager_) {
         webrtcManager_->removeAllPeers();
         webrtcManager_.reset();
@@ -747,20 +837,18 @@ void Application::shutdown() {
     if (messageHandler_) {
         messageHandler_.reset();
     }
+    auto networkMs = endPhase();
     
-    // 7. 파이프라인 중지 (CUDA 리소스 해제 전에)
+    // 7. 파이프라인 중지 (CUDA 리소스 해제 전에, stop()은 NULL 전환 완료 후 반환)
     if (pipeline_) {
         pipeline_->stop();
-        
-        // 파이프라인 상태가 완전히 NULL이 될 때까지 대기
-        int waitCount = 0;
-        while (pipeline_->getState() != GST_STATE_NULL && waitCount < 50) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            waitCount++;
-        }
-        
         pipeline_.reset();
     }
+    if (metadataExtractor_) {
+        metadataExtractor_->stop();
+        metadataExtractor_.reset();
+    }
+    auto pipelineMs = endPhase();
     
     // 8. 모니터링 중지
     SystemMonitor::getInstance().stop();
@@ -778,19 +866,22 @@ void Application::shutdown() {
     // 9. 하드웨어 정리
     SerialPort::getInstance().close();
     
-    // 10. 메인 루프 종료
+    // 10. 메인 루프 종료 (g_main_loop_run 반환은 run()에서 처리)
     if (mainLoop_) {
         g_main_loop_quit(mainLoop_);
-        
-        // 메인 루프가 완전히 종료될 때까지 대기
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        
         g_main_loop_unref(mainLoop_);
         mainLoop_ = nullptr;
     }
     
+#ifdef HAVE_CUDA
     // 11. CUDA 컨텍스트 정리 (마지막에)
     cudaDeviceReset();
+#endif
+    auto cleanupMs = endPhase();
+    
+    LOG_INFO("Shutdown took {} ms (recordings {}, network {}, pipeline {}, cleanup {})",
+             std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - shutdownStart).count(),
+             recordingsMs, networkMs, pipelineMs, cleanupMs);
     
     // 통계 출력
     auto uptime = std::chrono::steady_clock::now() - stats_.startTime;
@@ -819,6 +910,12 @@ void Application::onWebSocketConnected() {
     setState(State::CONNECTED);
     reconnectAttempts_ = 0;
     
+    // 새 연결에서는 스냅샷을 다시 전송
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        sentSnapshotVersions_.clear();
+    }
+    
     // 서버에 등록
     const auto& config = Config::getInstance().getWebRTCConfig();
     messageHandler_->sendRegistration(config.cameraId);
@@ -911,6 +1008,7 @@ void Application::heartbeatThread() {
    
    // 초기 대기 (파이프라인 안정화)
    std::this_thread::sleep_for(std::chrono::seconds(3));
+   lastLatencyLog_ = std::chrono::steady_clock::now();
    
    while (running_) {
        try {
@@ -934,6 +1032,19 @@ void Application::heartbeatThread() {
                lastSettingsCheck = now;
            }
            
+           // 시청자/SoC 온도/이벤트 상태에 따른 프레임레이트 상한 (rate_governor 설정 시)
+           applyRateGovernor();
+
+           // 지점별 지연 분포 로깅 (latency_tracing 설정 시)
+           if (config.latencyTracing && pipeline_ && now - lastLatencyLog_ > std::chrono::seconds(30)) {
+               for (const auto& point : pipeline_->getLatencyReport()) {
+                   LOG_INFO("Latency {}: p50 {:.1f}ms, p95 {:.1f}ms, p99 {:.1f}ms, max {:.1f}ms ({} samples, {} unmatched)",
+                            point.name, point.p50Ms, point.p95Ms, point.p99Ms, point.maxMs,
+                            point.samples, point.unmatched);
+               }
+               lastLatencyLog_ = now;
+           }
+
        } catch (const std::exception& e) {
            LOG_ERROR("Exception in heartbeat thread: {}", e.what());
        }
@@ -951,25 +1062,28 @@ void Application::sendCameraStatus() {
        LOG_DEBUG("WebSocket connected, active peers: {}", 
               webrtcManager_ ? webrtcManager_->getPeerCount() : 0);
        
-       // 스냅샷 이미지를 Base64로 인코딩
-       std::string rgbSnapshot = encodeImageToBase64(
-           config.snapshotPath + "/cam0_snapshot.jpg");
-       std::string thermalSnapshot;
-       
-       if (config.deviceCnt > 1) {
-           thermalSnapshot = encodeImageToBase64(
-               config.snapshotPath + "/cam1_snapshot.jpg");
-       }
-       
        Signaling::CameraStatusMessage status;
        status.recordStatus = deviceSettings.recordStatus ? "On" : "Off";
        status.recordUsage = sysStatus.storageUsagePercent;
        status.cpuTemp = sysStatus.cpuTemp;
        status.gpuTemp = sysStatus.gpuTemp;
-       status.rgbSnapshot = rgbSnapshot;
-       status.thermalSnapshot = thermalSnapshot;
        
-       messageHandler_->sendCameraStatus(status);
+       // 스냅샷은 마지막 전송 이후 바뀐 경우에만 포함 (전송에 성공한 버전만 보낸 것으로 기록)
+       uint64_t rgbVersion = 0;
+       uint64_t thermalVersion = 0;
+       status.rgbSnapshot = snapshotForStatus(0, config.snapshotPath, rgbVersion);
+       if (config.deviceCnt > 1) {
+           status.thermalSnapshot = snapshotForStatus(1, config.snapshotPath, thermalVersion);
+       } else {
+           status.thermalSnapshot = std::string();
+       }
+       
+       if (!messageHandler_->sendCameraStatus(status)) {
+           LOG_WARNING("Camera status not sent, snapshots will be retried");
+           return;
+       }
+       markSnapshotSent(0, rgbVersion);
+       markSnapshotSent(1, thermalVersion);
        
    } catch (const std::exception& e) {
        LOG_ERROR("Failed to send camera status: {}", e.what());
@@ -1012,63 +1126,85 @@ void Application::checkAndReconnect() {
 
 // 분석 프로브 설정
 void Application::setupAnalysisProbes() {
-    const auto& config = Config::getInstance().getWebRTCConfig();
+    int cameras = pipeline_->getCameraCount();
+    analysisFrameCounts_.assign(cameras, 0);
     
-    for (int i = 0; i < config.deviceCnt; ++i) {
-        std::string osdName = "nvosd_" + std::to_string(i + 1);
-        
-        // OSD 엘리먼트가 있는 경우에만 프로브 추가
-        if (pipeline_->getElement(osdName)) {
-            pipeline_->addProbe(osdName, "sink", GST_PAD_PROBE_TYPE_BUFFER,
-                [this, i](GstPad* /*pad*/, GstPadProbeInfo* info) {  // 미사용 매개변수 주석 처리
-                    return processVideoFrame(i, GST_PAD_PROBE_INFO_BUFFER(info));
-                }
-            );
-            LOG_INFO("Added analysis probe for camera {}", i);
-        }
+    // OSD 스트리밍 스레드는 메타 복사만 하고, 분석은 추출기 워커 스레드에서 수행
+    metadataExtractor_ = std::make_unique<MetadataExtractor>(cameras, inferenceMeta_);
+    metadataExtractor_->start([this](const MetadataExtractor::Frame& frame) {
+        analyzeFrame(frame);
+    });
+    
+    for (int i = 0; i < cameras; ++i) {
+        setupAnalysisProbe(i);
     }
 }
 
-// 비디오 프레임 처리
-GstPadProbeReturn Application::processVideoFrame(int cameraIndex, GstBuffer* buffer) {
-    // 여기서 실제 비디오 분석을 수행
-    static uint64_t frameCount[2] = {0, 0};
-    frameCount[cameraIndex]++;
-
-    // 10초마다 프레임 카운트 로그
-    if (frameCount[cameraIndex] % 300 == 0) {
-        LOG_INFO("Camera {} processed {} frames", cameraIndex, frameCount[cameraIndex]);
+// 카메라별 분석 프로브 (추론 브랜치가 재구성되면 새 OSD 엘리먼트에 다시 연결)
+void Application::setupAnalysisProbe(int cameraIndex) {
+    std::string osdName = "nvosd_" + std::to_string(cameraIndex + 1);
+    
+    // OSD 엘리먼트가 있는 경우에만 프로브 추가
+    GstElement* osd = pipeline_->getElement(osdName);
+    if (osd && metadataExtractor_ && metadataExtractor_->attach(cameraIndex, osd)) {
+        LOG_INFO("Added analysis probe for camera {}", cameraIndex);
     }
+}
 
-    NvDsBatchMeta *batch_meta = gst_buffer_get_nvds_batch_meta(buffer);
+// 프레임 분석 (메타 추출 워커 스레드)
+void Application::analyzeFrame(const MetadataExtractor::Frame& frame) {
+    // 여기서 실제 비디오 분석을 수행
+    uint64_t frameCount = ++analysisFrameCounts_[frame.camera];
 
-    if (!batch_meta) {
-        LOG_ERROR("Failed to get batch meta from buffer");
-        return GST_PAD_PROBE_DROP;
+    // 10초마다 프레임 카운트 로그
+    if (frameCount % 300 == 0) {
+        LOG_INFO("Camera {} processed {} frames ({} objects in latest frame)",
+                 frame.camera, frameCount, frame.objectCount);
     }
+}
 
-    // 메타데이터를 순회하며 분석
-    for (NvDsMetaList *l_frame = batch_meta->frame_meta_list; l_frame != nullptr; l_frame = l_frame->next) {
-        NvDsFrameMeta *frame_meta = reinterpret_cast<NvDsFrameMeta *>(l_frame->data);
-        if (!frame_meta) {
-            LOG_ERROR("Frame meta is null");
-            continue;
-        }  
-
-        // 프레임 메타에서 객체 메타를 순회
-        for (NvDsMetaList *l_obj = frame_meta->obj_meta_list; l_obj != nullptr; l_obj = l_obj->next) {
-            NvDsObjectMeta *obj_meta = reinterpret_cast<NvDsObjectMeta *>(l_obj->data);
-            if (!obj_meta) {
-                LOG_ERROR("Object meta is null");
-                continue;
-            }
-        }
-    }
+// 이미지를 Base64로 인코딩
+// 캐시의 base64를 그대로 사용하고, 이미 보낸 버전이면 nullopt (on_demand는 TTL이 지났을 때만 인코딩)
+// 캐시를 쓰지 않는 사용자 정의 snapshot 브랜치(파일 싱크)는 파일을 읽어 인코딩
+// version: 포함한 캐시 스냅샷 버전 (0 = 기록할 버전 없음), 전송 성공 후 markSnapshotSent()로 기록
+std::optional<std::string> Application::snapshotForStatus(int cameraIndex, const std::string& snapshotPath,
+                                                          uint64_t& version) {
+   version = 0;
+   SnapshotCache* cache = pipeline_ ? pipeline_->getSnapshotCache() : nullptr;
+   
+   if (!cache || !cache->isAttached(cameraIndex)) {
+       return encodeImageToBase64(snapshotPath + "/cam" + std::to_string(cameraIndex) + "_snapshot.jpg");
+   }
+   
+   auto snapshot = cache->get(cameraIndex);
+   if (!snapshot) {
+       return std::string();  // 첫 스냅샷 전
+   }
+   
+   std::lock_guard<std::mutex> lock(snapshotMutex_);
+   if (static_cast<int>(sentSnapshotVersions_.size()) <= cameraIndex) {
+       sentSnapshotVersions_.resize(cameraIndex + 1, 0);
+   }
+   if (snapshot->version == sentSnapshotVersions_[cameraIndex]) {
+       return std::nullopt;
+   }
+   
+   version = snapshot->version;
+   return *snapshot->base64;
+}
 
-    return GST_PAD_PROBE_OK;
+void Application::markSnapshotSent(int cameraIndex, uint64_t version) {
+   if (version == 0) {
+       return;
+   }
+   
+   std::lock_guard<std::mutex> lock(snapshotMutex_);
+   if (static_cast<int>(sentSnapshotVersions_.size()) <= cameraIndex) {
+       sentSnapshotVersions_.resize(cameraIndex + 1, 0);
+   }
+   sentSnapshotVersions_[cameraIndex] = version;
 }
 
-// 이미지를 Base64로 인코딩
 std::string Application::encodeImageToBase64(const std::string& filePath) {
    try {
        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
@@ -1157,7 +1293,7 @@ void Application::applyDeviceSettings() {
        }
        
        // 분석 상태 변경
-       // TODO: 파이프라인에 분석 ON/OFF 적용
+       applyAnalysisSettings();
        
        // 열화상 설정 업데이트
        if (thermalMonitor_) {
@@ -1179,6 +1315,74 @@ void Application::applyDeviceSettings() {
    }
 }
 
+// 분석 ON/OFF 및 추론 간격 (파이프라인 재구성 없이 valve/nvinfer 속성으로 적용)
+void Application::applyAnalysisSettings() {
+   if (!pipeline_ || !pipeline_->isRunning()) {
+       return;
+   }
+   
+   const auto& settings = Config::getInstance().getDeviceSettings();
+   for (int i = 0; i < pipeline_->getCameraCount(); ++i) {
+       pipeline_->setAnalysisEnabled(i, settings.analysisStatus);
+       
+       // nvinfer가 없는 분석(cpu 프로파일 스텁)은 메타 추출 단계에서 같은 간격으로 건너뜀
+       int applied = pipeline_->setInferenceInterval(i, settings.nvInterval);
+       if (metadataExtractor_) {
+           metadataExtractor_->setInterval(i, applied > 0 ? 0 : std::max(pipeline_->getInferenceInterval(i), 0));
+       }
+   }
+}
+
+// 프레임레이트 상한은 버퍼 드롭과 nvinfer interval로만 적용 (peer 재협상 없음)
+// 파이프라인이 재시작되어도 다음 주기에 다시 적용되도록 매번 현재 결정을 전달
+void Application::applyRateGovernor() {
+   if (!pipeline_ || !pipeline_->isRunning()) {
+       return;
+   }
+   
+   const auto& config = Config::getInstance().getWebRTCConfig().rateGovernor;
+   if (!config.enabled) {
+       if (rateGovernor_.current()) {
+           // 실행 중 비활성화: 상한 해제
+           rateGovernor_.reset();
+           for (int i = 0; i < pipeline_->getCameraCount(); ++i) {
+               pipeline_->setRateLimits(i, Pipeline::RateLimits{});
+           }
+           applyAnalysisSettings();
+           LOG_INFO("Rate governor disabled, frame rate limits cleared");
+       }
+       return;
+   }
+   
+   RateGovernor::Inputs inputs;
+   inputs.peers = webrtcManager_ ? static_cast<int>(webrtcManager_->getPeerCount()) : 0;
+   auto sysStatus = SystemMonitor::getInstance().getCurrentStatus();
+   inputs.socTempC = std::max(sysStatus.cpuTemp, sysStatus.gpuTemp);
+   // 이벤트 녹화 중이거나 과열 객체가 이벤트 발생 시간을 채우는 중
+   inputs.eventArmed = EventRecorder::getInstance().hasActiveEvent() ||
+                       (thermalMonitor_ && !thermalMonitor_->getOverTempObjects().empty());
+   auto time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+   inputs.hour = std::localtime(&time)->tm_hour;
+   
+   if (auto decision = rateGovernor_.update(config, inputs, std::chrono::steady_clock::now())) {
+       LOG_INFO("Rate governor: {}{}{} (peers {}, SoC {}C) -> source {} fps, infer {} fps, encoder {} fps",
+                RateGovernor::modeName(decision->mode), decision->event ? "+event" : "",
+                decision->hot ? "+hot" : "", inputs.peers, inputs.socTempC,
+                decision->rates.sourceFps, decision->rates.inferFps, decision->rates.encoderFps);
+   }
+   
+   const auto& current = rateGovernor_.current();
+   if (!current) {
+       return;
+   }
+   for (int i = 0; i < pipeline_->getCameraCount(); ++i) {
+       int applied = pipeline_->setRateLimits(i, current->rates);
+       if (metadataExtractor_ && applied == 0) {
+           metadataExtractor_->setInterval(i, std::max(pipeline_->getInferenceInterval(i), 0));
+       }
+   }
+}
+
 // 모니터링 콜백들
 void Application::onSystemAlert(const std::string& alert) {
    LOG_WARNING("System alert: {}", alert);
@@ -1218,8 +1422,40 @@ void Application::onConfigFileChanged(const std::filesystem::path& path) {
        // 디바이스 설정은 applyDeviceSettings()에서 처리
        LOG_INFO("Device settings will be applied on next check");
    } else if (path == configPath_) {
-       LOG_WARNING("Main configuration changed - restart required");
-       // TODO: 재시작이 필요한 설정 변경 알림
+       reconfigurePipeline();
+   }
+}
+
+// 메인 설정 변경 시 바뀐 카메라 브랜치만 재구성
+void Application::reconfigurePipeline() {
+   if (!pipeline_ || !pipeline_->isRunning()) {
+       LOG_WARNING("Main configuration changed - applied on next start");
+       return;
+   }
+   
+   if (!Config::getInstance().loadConfig(configPath_)) {
+       LOG_ERROR("Failed to reload config from: {}", configPath_);
+       return;
+   }
+   
+   auto webrtcConfig = Config::getInstance().getWebRTCConfig();
+   PipelineProfile::apply(webrtcConfig);
+   
+   auto result = pipeline_->reconfigure(webrtcConfig);
+   
+   for (const auto& branch : result.rebuilt) {
+       LOG_INFO("Pipeline branch rebuilt: {}", branch.name());
+       
+       // 추론 브랜치가 교체되면 분석 프로브도 새 OSD로 이동
+       if (branch.branch == "infer") {
+           setupAnalysisProbe(branch.camera);
+       }
+   }
+   for (const auto& branch : result.failed) {
+       LOG_ERROR("Pipeline branch rebuild failed, keeping previous branch: {}", branch.name());
+   }
+   if (result.restartRequired) {
+       LOG_WARNING("Main configuration changed - restart required for remaining changes");
    }
 }
 
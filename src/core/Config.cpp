@@ -21,9 +21,67 @@ bool Config::loadConfig(const std::filesystem::path& configPath) {
         webrtcConfig_.maxStreamCount = j.value("max_stream_cnt", 10);
         webrtcConfig_.streamBasePort = j.value("stream_base_port", 5000);
         webrtcConfig_.deviceCnt = j.value("device_cnt", 2);
+        webrtcConfig_.streamTransport = j.value("stream_transport", "udp");
+        webrtcConfig_.egressBufferLists = j.value("egress_buffer_lists", false);
+        webrtcConfig_.encodeOnce = j.value("encode_once", false);
+        webrtcConfig_.lazyEncoderActivation = j.value("lazy_encoder_activation", false);
+        webrtcConfig_.gopCacheMaxAgeMs = j.value("gop_cache_max_age_ms", 1000);
+        webrtcConfig_.latencyTracing = j.value("latency_tracing", false);
+        webrtcConfig_.pipelineProfile = j.value("pipeline_profile", "jetson");
+        if (j.contains("cpu_sources")) {
+            webrtcConfig_.cpuSources = j["cpu_sources"].get<std::vector<std::string>>();
+        }
+        
+        // 동적 스트림 포트 범위
+        if (j.contains("dynamic_port_range") && j["dynamic_port_range"].size() == 2) {
+            webrtcConfig_.dynamicPortStart = j["dynamic_port_range"][0].get<int>();
+            webrtcConfig_.dynamicPortEnd = j["dynamic_port_range"][1].get<int>();
+        }
+        if (j.contains("reserved_port_ranges")) {
+            webrtcConfig_.reservedPortRanges.clear();
+            for (const auto& range : j["reserved_port_ranges"]) {
+                if (range.size() == 2) {
+                    webrtcConfig_.reservedPortRanges.emplace_back(range[0].get<int>(), range[1].get<int>());
+                }
+            }
+        }
         
         // 경로 설정
         webrtcConfig_.snapshotPath = j.value("snapshot_path", "/home/nvidia/webrtc");
+        webrtcConfig_.snapshotMode = j.value("snapshot_mode", "continuous");
+        webrtcConfig_.sharedScaler = j.value("shared_scaler", false);
+        webrtcConfig_.cachedClockOverlay = j.value("cached_clock_overlay", false);
+        webrtcConfig_.stallTimeoutMs = j.value("stall_timeout_ms", 0);
+        webrtcConfig_.stallRecoveryAttempts = j.value("stall_recovery_attempts", 3);
+        webrtcConfig_.analysisBypass = j.value("analysis_bypass", false);
+        
+        // 프레임레이트 조절
+        webrtcConfig_.rateGovernor = RateGovernorConfig{};
+        if (j.contains("rate_governor")) {
+            auto governor = j["rate_governor"];
+            auto& rateGovernor = webrtcConfig_.rateGovernor;
+            auto parseRates = [&governor](const char* key, RateConfig& rates) {
+                if (!governor.contains(key)) return;
+                auto stage = governor[key];
+                rates.sourceFps = stage.value("source_fps", 0);
+                rates.inferFps = stage.value("infer_fps", 0);
+                rates.encoderFps = stage.value("encoder_fps", 0);
+            };
+            rateGovernor.enabled = governor.value("enabled", false);
+            parseRates("watching", rateGovernor.watching);
+            parseRates("idle", rateGovernor.idle);
+            parseRates("night", rateGovernor.night);
+            parseRates("event", rateGovernor.event);
+            parseRates("hot", rateGovernor.hot);
+            if (governor.contains("night_hours") && governor["night_hours"].size() == 2) {
+                rateGovernor.nightStartHour = governor["night_hours"][0].get<int>();
+                rateGovernor.nightEndHour = governor["night_hours"][1].get<int>();
+            }
+            rateGovernor.hotTempC = governor.value("hot_temp_c", 85);
+            rateGovernor.coolTempC = governor.value("cool_temp_c", 78);
+            rateGovernor.holdSeconds = governor.value("hold_seconds", 30);
+        }
+        webrtcConfig_.snapshotTtlMs = j.value("snapshot_ttl_ms", 2000);
         webrtcConfig_.recordPath = j.value("record_path", "/home/nvidia/data");
         webrtcConfig_.deviceSettingPath = j.value("device_setting_path", "/home/nvidia/webrtc/device_setting.json");
         
@@ -49,18 +107,32 @@ bool Config::loadConfig(const std::filesystem::path& configPath) {
             webrtcConfig_.ttyBaudrate = tty.value("baudrate", 38400);
         }
         
-        // 비디오 설정 파싱 (video0, video1)
-        for (int i = 0; i < webrtcConfig_.deviceCnt && i < 2; ++i) {
+        // 비디오 설정 파싱 (video0 ~ video{device_cnt-1})
+        webrtcConfig_.video.clear();
+        for (int i = 0; i < webrtcConfig_.deviceCnt; ++i) {
             std::string videoKey = "video" + std::to_string(i);
-            if (j.contains(videoKey)) {
-                auto video = j[videoKey];
-                webrtcConfig_.video[i].src = video.value("src", "");
-                webrtcConfig_.video[i].record = video.value("record", "");
-                webrtcConfig_.video[i].infer = video.value("infer", "");
-                webrtcConfig_.video[i].enc = video.value("enc", "");
-                webrtcConfig_.video[i].enc2 = video.value("enc2", "");
-                webrtcConfig_.video[i].snapshot = video.value("snapshot", "");
+            if (!j.contains(videoKey)) {
+                // cpu 프로파일은 누락된 카메라를 테스트 패턴으로 채움, jetson은 파이프라인에서 제외
+                LOG_WARNING("{} not configured ({} of {} cameras have video branches)",
+                            videoKey, i, webrtcConfig_.deviceCnt);
+                break;
             }
+            
+            auto video = j[videoKey];
+            std::string defaultLabel = i == 0 ? "RGB" : (i == 1 ? "Thermal" : "cam" + std::to_string(i));
+            
+            VideoConfig videoConfig;
+            videoConfig.label = video.value("label", defaultLabel);
+            videoConfig.src = video.value("src", "");
+            videoConfig.record = video.value("record", "");
+            videoConfig.infer = video.value("infer", "");
+            videoConfig.enc = video.value("enc", "");
+            videoConfig.enc2 = video.value("enc2", "");
+            videoConfig.snapshot = video.value("snapshot", "");
+            videoConfig.ioMode = video.value("io_mode", "");
+            videoConfig.poolMinBuffers = video.value("pool_min_buffers", 0);
+            videoConfig.poolMaxBuffers = video.value("pool_max_buffers", 0);
+            webrtcConfig_.video.push_back(std::move(videoConfig));
         }
 
         LOG_INFO("Config loaded successfully from: {}", configPath.string());
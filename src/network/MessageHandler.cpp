@@ -153,12 +153,10 @@ void MessageHandler::sendRegistration(const std::string& cameraId) {
     }
 }
 
-void MessageHandler::sendCameraStatus(const Signaling::CameraStatusMessage& status) {
+bool MessageHandler::sendCameraStatus(const Signaling::CameraStatusMessage& status) {
     auto jsonStr = Signaling::MessageParser::serialize(status);
     
-    if (sendCallback_) {
-        sendCallback_(jsonStr);
-    }
+    return sendCallback_ && sendCallback_(jsonStr);
 }
 
 void MessageHandler::sendOffer(const std::string& peerId, const std::string& sdp) {
@@ -60,10 +60,14 @@ std::string MessageParser::serialize(const Message& message) {
                 {"rec_status", msg.recordStatus},
                 {"rec_usage", msg.recordUsage},
                 {"cpu_temp", msg.cpuTemp},
-                {"gpu_temp", msg.gpuTemp},
-                {"rgb_snapshot", msg.rgbSnapshot},
-                {"thermal_snapshot", msg.thermalSnapshot}
+                {"gpu_temp", msg.gpuTemp}
             };
+            if (msg.rgbSnapshot) {
+                j["message"]["rgb_snapshot"] = *msg.rgbSnapshot;
+            }
+            if (msg.thermalSnapshot) {
+                j["message"]["thermal_snapshot"] = *msg.thermalSnapshot;
+            }
         },
         [&j](const OfferMessage& msg) {
             j["peerType"] = "camera";
@@ -1,6 +1,13 @@
 #include "network/WebRTCManager.hpp"
 #include "core/Logger.hpp"
 
+namespace {
+
+// 프로세스 내부 전달 appsrc 대기열 상한 (2Mbps 메인 스트림 약 1초)
+constexpr guint64 kInProcessMaxBytes = 256 * 1024;
+
+}  // namespace
+
 WebRTCManager::WebRTCManager(std::shared_ptr<Pipeline> pipeline)
     : pipeline_(pipeline), 
     asyncTasks_(std::make_unique<ThreadPool>(4)) {
@@ -80,41 +87,60 @@ bool WebRTCManager::removePeer(const std::string& peerId) {
     
     LOG_INFO("Removing peer: {}", peerId);
     
+    releasePeer(peerId, *it->second);
+    
+    // Peer 제거
+    peers_.erase(it);
+    
+    LOG_INFO("Peer removed: {} (remaining peers: {})", peerId, peers_.size());
+    return true;
+}
+
+// peer 연결/스트림/UDP source 정리 (peers_에서 분리된 context 또는 mutex_ 보유 상태에서 호출)
+void WebRTCManager::releasePeer(const std::string& peerId, PeerContext& context) {
     // WebRTC 연결 종료
-    it->second->peer->disconnect();
+    context.peer->disconnect();
     
     // 동적 스트림 제거
     pipeline_->removeStream(peerId);
     
     // UDP source 정리
-    if (it->second->udpSrc) {
-        gst_element_set_state(it->second->udpSrc, GST_STATE_NULL);
-        gst_object_unref(it->second->udpSrc);
+    if (context.udpSrc) {
+        gst_element_set_state(context.udpSrc, GST_STATE_NULL);
+        gst_object_unref(context.udpSrc);
+        context.udpSrc = nullptr;
     }
-    
-    // Peer 제거
-    peers_.erase(it);
-    
-    LOG_INFO("Peer removed: {} (remaining peers: {})", peerId, peers_.size());
-    return true;
 }
 
 void WebRTCManager::removeAllPeers() {
-    LOG_INFO("Removing all peers");
-    
-    // 복사본을 만들어서 순회 (iterator 무효화 방지)
-    std::vector<std::string> peerIds;
+    // 맵에서 한 번에 분리한 뒤 peer별 연결 종료(NULL 전환)는 병렬 처리
+    std::unordered_map<std::string, std::unique_ptr<PeerContext>> peers;
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        for (const auto& [peerId, context] : peers_) {
-            peerIds.push_back(peerId);
-        }
+        peers.swap(peers_);
     }
     
-    // 각 peer 제거
-    for (const auto& peerId : peerIds) {
-        removePeer(peerId);
+    if (peers.empty()) {
+        return;
+    }
+    
+    LOG_INFO("Removing all peers ({})", peers.size());
+    auto start = std::chrono::steady_clock::now();
+    
+    std::vector<std::future<void>> releases;
+    for (auto& [peerId, context] : peers) {
+        releases.push_back(asyncTasks_->enqueue([this, &peerId = peerId, &context = context]() {
+            releasePeer(peerId, *context);
+        }));
     }
+    for (auto& release : releases) {
+        release.wait();
+    }
+    peers.clear();
+    
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    LOG_INFO("All peers removed in {} ms", elapsed.count());
 }
 
 bool WebRTCManager::createPeerConnection(const std::string& peerId, 
@@ -138,6 +164,16 @@ bool WebRTCManager::createPeerConnection(const std::string& peerId,
         return false;
     }
     
+    // 프로세스 내부 전달: 이미 페이로드된 RTP 버퍼를 appsrc로 직접 받음
+    if (pipeline_->getTransport() == StreamTransport::APPSINK) {
+        return createInProcessConnection(context.get());
+    }
+    
+    // 공유 파이프라인: peer별 파이프라인 없이 메인 파이프라인에 webrtcbin bin 추가
+    if (pipeline_->getTransport() == StreamTransport::SHARED_PIPELINE) {
+        return createSharedConnection(context.get());
+    }
+    
     // UDP 소스 생성
     context->udpSrc = gst_element_factory_make("udpsrc", nullptr);
     if (!context->udpSrc) {
@@ -173,6 +209,81 @@ bool WebRTCManager::createPeerConnection(const std::string& peerId,
     return true;
 }
 
+bool WebRTCManager::createInProcessConnection(PeerContext* context) {
+    const std::string& peerId = context->info.peerId;
+    
+    GstElement* appSrc = gst_element_factory_make("appsrc", nullptr);
+    if (!appSrc) {
+        LOG_ERROR("Failed to create app source for peer {}", peerId);
+        return false;
+    }
+    
+    GstCaps* caps = gst_caps_from_string(
+        "application/x-rtp,media=video,clock-rate=90000,encoding-name=H264,payload=96");
+    
+    g_object_set(appSrc,
+                 "caps", caps,
+                 "is-live", TRUE,
+                 "format", GST_FORMAT_TIME,
+                 "do-timestamp", TRUE,
+                 "block", FALSE,
+                 "max-bytes", kInProcessMaxBytes,
+                 nullptr);
+    
+    // webrtcbin이 멈춰도 대기열이 자라지 않도록 오래된 버퍼부터 버림 (udp 경로의 leaky queue와 동일)
+    // leaky-type이 없는 GStreamer(< 1.20)에서는 Pipeline이 전달 전에 대기열 크기를 보고 새 버퍼를 버림
+    if (g_object_class_find_property(G_OBJECT_GET_CLASS(appSrc), "leaky-type")) {
+        g_object_set(appSrc, "leaky-type", 2 /* GST_APP_LEAKY_TYPE_DOWNSTREAM */, nullptr);
+    }
+    
+    gst_caps_unref(caps);
+    
+    // 메인 파이프라인의 appsink -> appsrc 연결 (appsink가 appsrc 참조를 보유)
+    if (!pipeline_->connectAppSource(peerId, appSrc)) {
+        LOG_ERROR("Failed to connect app source for peer {}", peerId);
+        gst_object_unref(appSrc);
+        return false;
+    }
+    
+    LOG_INFO("Created in-process RTP source for peer {}", peerId);
+    
+    // depay/repay 없이 webrtcbin에 바로 연결
+    if (!context->peer->connectToRtpStream(appSrc)) {
+        LOG_ERROR("Failed to connect WebRTC peer to in-process stream");
+        pipeline_->disconnectAppSource(peerId);
+        // peer 파이프라인에 추가되기 전 실패했다면 floating 참조를 직접 해제
+        if (!GST_OBJECT_PARENT(appSrc)) {
+            gst_object_unref(appSrc);
+        }
+        return false;
+    }
+    
+    context->appSrc = appSrc;
+    return true;
+}
+
+bool WebRTCManager::createSharedConnection(PeerContext* context) {
+    const std::string& peerId = context->info.peerId;
+    
+    GstElement* peerBin = context->peer->createSharedBin();
+    if (!peerBin) {
+        LOG_ERROR("Failed to create shared WebRTC bin for peer {}", peerId);
+        return false;
+    }
+    
+    // 메인 파이프라인의 tee -> queue -> peer bin 연결 (상태는 메인 파이프라인을 따름)
+    if (!pipeline_->attachPeerBin(peerId, peerBin)) {
+        LOG_ERROR("Failed to attach WebRTC bin for peer {}", peerId);
+        context->peer->disconnect();
+        return false;
+    }
+    
+    LOG_INFO("Attached WebRTC bin for peer {} to shared pipeline", peerId);
+    
+    context->peer->startNegotiation();
+    return true;
+}
+
 bool WebRTCManager::handleOffer(const std::string& peerId, const std::string& sdp) {
     std::lock_guard<std::mutex> lock(mutex_);
     
@@ -243,6 +354,13 @@ void WebRTCManager::setupPeerCallbacks(PeerContext* context) {
         }
     );
     
+    // 미디어 경로 준비 콜백 (GOP 캐시로 첫 프레임 즉시 전달)
+    context->peer->setMediaReadyCallback(
+        [this, peerId]() {
+            pipeline_->primeDynamicStream(peerId);
+        }
+    );
+    
     // 에러 콜백
     context->peer->setErrorCallback(
         [this, peerId](const std::string& error) {
@@ -303,18 +421,13 @@ void WebRTCManager::onError(const std::string& peerId, const std::string& error)
 }
 
 CameraDevice WebRTCManager::parseSource(const std::string& source) const {
-    // 소스 문자열에서 디바이스 타입 파싱
-    if (source.find("RGB") != std::string::npos || 
-        source.find("rgb") != std::string::npos ||
-        source == "0") {  // video0
-        return CameraDevice::RGB;
-    } else if (source.find("Thermal") != std::string::npos || 
-               source.find("thermal") != std::string::npos ||
-               source == "1") {  // video1
-        return CameraDevice::THERMAL;
+    // 소스 문자열에서 카메라 파싱 (label, camN/videoN, 인덱스)
+    if (auto device = pipeline_->resolveCamera(source)) {
+        return *device;
     }
     
     // 기본값
+    LOG_WARNING("Unknown camera source '{}', using camera 0", source);
     return CameraDevice::RGB;
 }
 
@@ -348,10 +461,19 @@ void WebRTCManager::logConnectionStats() const {
     LOG_INFO("=== WebRTC Connection Statistics ===");
     LOG_INFO("Total peers: {}", totalPeers);
     LOG_INFO("Connected peers: {}", connectedPeers);
-    LOG_INFO("RGB streams: {}", deviceCount[CameraDevice::RGB]);
-    LOG_INFO("Thermal streams: {}", deviceCount[CameraDevice::THERMAL]);
+    for (int i = 0; i < pipeline_->getCameraCount(); ++i) {
+        LOG_INFO("Camera {} streams: {}", i, deviceCount[cameraDeviceAt(i)]);
+    }
     LOG_INFO("Main streams: {}", streamTypeCount[StreamType::MAIN]);
     LOG_INFO("Secondary streams: {}", streamTypeCount[StreamType::SECONDARY]);
+    
+    // peer별 송출 통계 (오버런 = leaky queue에서 드롭된 버퍼)
+    for (const auto& [peerId, egress] : pipeline_->getEgressStatistics()) {
+        double perSend = egress.sends ? static_cast<double>(egress.buffers) / egress.sends : 0.0;
+        LOG_INFO("Peer {}: {} bytes, {} buffers in {} sends ({} lists, {:.1f} buffers/send), {} overruns, queue {} buffers",
+                 peerId, egress.bytes, egress.buffers, egress.sends, egress.lists, perSend,
+                 egress.overruns, egress.queueLevelBuffers);
+    }
     LOG_INFO("==================================");
 }
 
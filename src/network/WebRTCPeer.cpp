@@ -1,10 +1,12 @@
 #include "network/WebRTCPeer.hpp"
+#include "video/BusDispatcher.hpp"
 #include "core/Logger.hpp"
 #include <nlohmann/json.hpp>
 
 struct WebRTCPeer::Impl {
     GstElement* webrtcbin = nullptr;
     GstElement* pipeline = nullptr;
+    GstElement* bin = nullptr;  // 공유 파이프라인 모드: 메인 Pipeline에 추가되는 peer bin
     GstPromise* promise = nullptr;
     
     // 시그널 핸들러 ID들
@@ -13,11 +15,17 @@ struct WebRTCPeer::Impl {
     gulong onIceGatheringStateId = 0;
     gulong onConnectionStateId = 0;
     
+    uint32_t busOwnerId = 0;  // BusDispatcher 등록 ID (전용 파이프라인 또는 공유 모드 bin)
+    
     ~Impl() {
         cleanup();
     }
     
     void cleanup() {
+        // 파이프라인 정지 전에 해제 (이후 상태 변경 메시지는 전달하지 않음)
+        BusDispatcher::getInstance().detach(busOwnerId);
+        busOwnerId = 0;
+        
         if (webrtcbin) {
             if (onNegotiationNeededId) {
                 g_signal_handler_disconnect(webrtcbin, onNegotiationNeededId);
@@ -39,7 +47,13 @@ struct WebRTCPeer::Impl {
             pipeline = nullptr;
         }
         
-        webrtcbin = nullptr;  // pipeline이 webrtcbin을 소유하므로 별도 unref 불필요
+        // 공유 모드의 bin 상태 전환/제거는 메인 Pipeline이 담당하므로 참조만 해제
+        if (bin) {
+            gst_object_unref(bin);
+            bin = nullptr;
+        }
+        
+        webrtcbin = nullptr;  // pipeline(또는 bin)이 webrtcbin을 소유하므로 별도 unref 불필요
     }
     
     // 정적 콜백 함수들
@@ -49,7 +63,8 @@ struct WebRTCPeer::Impl {
     static void onConnectionState(GstElement* element, GParamSpec* pspec, gpointer userData);
     static void onOfferCreated(GstPromise* promise, gpointer userData);
     static void onAnswerCreated(GstPromise* promise, gpointer userData);
-    static void busMessage(GstBus* bus, GstMessage* message, gpointer userData);
+    static void busMessage(GstMessage* message, WebRTCPeer* peer);
+    void attachBus(GstElement* owner, WebRTCPeer* peer);
 };
 
 WebRTCPeer::WebRTCPeer(const Config& config) 
@@ -67,34 +82,10 @@ bool WebRTCPeer::connectToStream(GstElement* udpSrc) {
         return false;
     }
     
-    // 방법 1: 파이프라인 문자열로 생성하는 대신 프로그래밍 방식으로 생성
-    impl_->pipeline = gst_pipeline_new(nullptr);
-    if (!impl_->pipeline) {
-        LOG_ERROR("Failed to create pipeline");
-        return false;
-    }
-    
-    // WebRTCBin 엘리먼트 직접 생성
-    impl_->webrtcbin = gst_element_factory_make("webrtcbin", "webrtc");
-    if (!impl_->webrtcbin) {
-        LOG_ERROR("Failed to create webrtcbin element - check if gstreamer1.0-plugins-bad is installed");
-        gst_object_unref(impl_->pipeline);
-        impl_->pipeline = nullptr;
+    if (!createWebRTCBin()) {
         return false;
     }
     
-    // WebRTCBin 설정
-    g_object_set(impl_->webrtcbin,
-                 "bundle-policy", GST_WEBRTC_BUNDLE_POLICY_MAX_BUNDLE,
-                 "stun-server", config_.stunServer.c_str(),
-                 nullptr);
-    
-    if (config_.useTurn && !config_.turnServer.empty()) {
-        g_object_set(impl_->webrtcbin,
-                     "turn-server", config_.turnServer.c_str(),
-                     nullptr);
-    }
-    
     // RTP 엘리먼트들 생성
     GstElement* rtpDepay = gst_element_factory_make("rtph264depay", nullptr);
     GstElement* h264parse = gst_element_factory_make("h264parse", nullptr);
@@ -105,7 +96,6 @@ bool WebRTCPeer::connectToStream(GstElement* udpSrc) {
         if (rtpDepay) gst_object_unref(rtpDepay);
         if (h264parse) gst_object_unref(h264parse);
         if (rtpPay) gst_object_unref(rtpPay);
-        gst_object_unref(impl_->webrtcbin);
         gst_object_unref(impl_->pipeline);
         impl_->webrtcbin = nullptr;
         impl_->pipeline = nullptr;
@@ -120,7 +110,7 @@ bool WebRTCPeer::connectToStream(GstElement* udpSrc) {
     
     // 파이프라인에 엘리먼트 추가
     gst_bin_add_many(GST_BIN(impl_->pipeline), 
-                     udpSrc, rtpDepay, h264parse, rtpPay, impl_->webrtcbin, 
+                     udpSrc, rtpDepay, h264parse, rtpPay, 
                      nullptr);
     
     // 엘리먼트 링크
@@ -132,22 +122,148 @@ bool WebRTCPeer::connectToStream(GstElement* udpSrc) {
         return false;
     }
     
-    // RTP payloader를 WebRTCBin에 연결
-    GstPad* srcPad = gst_element_get_static_pad(rtpPay, "src");
+    // caps 설정
+    GstCaps* caps = gst_caps_from_string(
+        "application/x-rtp,media=video,encoding-name=H264,payload=96,clock-rate=90000");
+    g_object_set(rtpPay, "caps", caps, nullptr);
+    gst_caps_unref(caps);
+    
+    return linkAndStart(rtpPay);
+}
+
+bool WebRTCPeer::connectToRtpStream(GstElement* rtpSrc) {
+    if (!rtpSrc) {
+        LOG_ERROR("Invalid RTP source");
+        return false;
+    }
+    
+    if (!createWebRTCBin()) {
+        return false;
+    }
+    
+    // 메인 파이프라인에서 이미 페이로드된 RTP 버퍼를 그대로 webrtcbin에 전달
+    // (depay -> parse -> pay 재처리 없음)
+    gst_bin_add(GST_BIN(impl_->pipeline), rtpSrc);
+    
+    return linkAndStart(rtpSrc);
+}
+
+bool WebRTCPeer::createWebRTCBin() {
+    // 방법 1: 파이프라인 문자열로 생성하는 대신 프로그래밍 방식으로 생성
+    impl_->pipeline = gst_pipeline_new(nullptr);
+    if (!impl_->pipeline) {
+        LOG_ERROR("Failed to create pipeline");
+        return false;
+    }
+    
+    if (!makeWebRTCBin()) {
+        gst_object_unref(impl_->pipeline);
+        impl_->pipeline = nullptr;
+        return false;
+    }
+    
+    gst_bin_add(GST_BIN(impl_->pipeline), impl_->webrtcbin);
+    return true;
+}
+
+bool WebRTCPeer::makeWebRTCBin() {
+    // WebRTCBin 엘리먼트 직접 생성
+    impl_->webrtcbin = gst_element_factory_make("webrtcbin", "webrtc");
+    if (!impl_->webrtcbin) {
+        LOG_ERROR("Failed to create webrtcbin element - check if gstreamer1.0-plugins-bad is installed");
+        return false;
+    }
+    
+    // WebRTCBin 설정
+    g_object_set(impl_->webrtcbin,
+                 "bundle-policy", GST_WEBRTC_BUNDLE_POLICY_MAX_BUNDLE,
+                 "stun-server", config_.stunServer.c_str(),
+                 nullptr);
+    
+    if (config_.useTurn && !config_.turnServer.empty()) {
+        g_object_set(impl_->webrtcbin,
+                     "turn-server", config_.turnServer.c_str(),
+                     nullptr);
+    }
+    
+    return true;
+}
+
+GstElement* WebRTCPeer::createSharedBin() {
+    if (impl_->bin || impl_->pipeline) {
+        LOG_ERROR("WebRTC peer {} already connected", config_.peerId);
+        return nullptr;
+    }
+    
+    if (!makeWebRTCBin()) {
+        return nullptr;
+    }
+    
+    std::string binName = "peerbin_" + config_.peerId;
+    GstElement* bin = gst_bin_new(binName.c_str());
+    gst_bin_add(GST_BIN(bin), impl_->webrtcbin);
+    
+    // webrtcbin sink pad를 bin의 ghost pad로 노출 (메인 Pipeline의 tee 브랜치와 연결)
+    GstPad* sinkPad = gst_element_get_request_pad(impl_->webrtcbin, "sink_%u");
+    if (!sinkPad) {
+        LOG_ERROR("Failed to get sink pad from webrtcbin");
+        gst_object_unref(bin);
+        impl_->webrtcbin = nullptr;
+        return nullptr;
+    }
+    
+    GstPad* ghostPad = gst_ghost_pad_new("sink", sinkPad);
+    gst_element_add_pad(bin, ghostPad);
+    gst_object_unref(sinkPad);
+    
+    connectSignals();
+    
+    // bin 참조를 보유 - 메인 Pipeline에서 제거되어도 disconnect()까지 유효
+    impl_->bin = GST_ELEMENT(gst_object_ref_sink(bin));
+    
+    // 메인 버스로 올라오는 bin 내부 메시지를 이 peer로 라우팅 (LATENCY 등은 메인 Pipeline이 처리)
+    impl_->attachBus(impl_->bin, this);
+    
+    LOG_DEBUG("Shared WebRTC bin created for peer: {}", config_.peerId);
+    return impl_->bin;
+}
+
+void WebRTCPeer::startNegotiation() {
+    setState(State::CONNECTING);
+    
+    // negotiation-needed 시그널이 발생하지 않을 수 있으므로 수동으로 offer 생성
+    g_idle_add([](gpointer data) -> gboolean {
+        auto* peer = static_cast<WebRTCPeer*>(data);
+        peer->createOffer();
+        return G_SOURCE_REMOVE;
+    }, this);
+}
+
+void WebRTCPeer::connectSignals() {
+    impl_->onNegotiationNeededId = g_signal_connect(impl_->webrtcbin, 
+        "on-negotiation-needed", G_CALLBACK(Impl::onNegotiationNeeded), this);
+    
+    impl_->onIceCandidateId = g_signal_connect(impl_->webrtcbin, 
+        "on-ice-candidate", G_CALLBACK(Impl::onIceCandidate), this);
+    
+    impl_->onIceGatheringStateId = g_signal_connect(impl_->webrtcbin, 
+        "notify::ice-gathering-state", G_CALLBACK(Impl::onIceGatheringState), this);
+    
+    impl_->onConnectionStateId = g_signal_connect(impl_->webrtcbin, 
+        "notify::connection-state", G_CALLBACK(Impl::onConnectionState), this);
+}
+
+bool WebRTCPeer::linkAndStart(GstElement* rtpSource) {
+    // RTP 소스를 WebRTCBin에 연결
+    GstPad* srcPad = gst_element_get_static_pad(rtpSource, "src");
     if (!srcPad) {
-        LOG_ERROR("Failed to get src pad from rtppay");
+        LOG_ERROR("Failed to get src pad from RTP source");
         gst_object_unref(impl_->pipeline);
         impl_->pipeline = nullptr;
         impl_->webrtcbin = nullptr;
         return false;
     }
     
-    // caps 설정
-    GstCaps* caps = gst_caps_from_string(
-        "application/x-rtp,media=video,encoding-name=H264,payload=96,clock-rate=90000");
-    g_object_set(rtpPay, "caps", caps, nullptr);
-    gst_caps_unref(caps);
-    
     // WebRTCBin sink pad 요청
     GstPad* sinkPad = gst_element_get_request_pad(impl_->webrtcbin, "sink_%u");
     if (!sinkPad) {
@@ -175,23 +291,10 @@ bool WebRTCPeer::connectToStream(GstElement* udpSrc) {
     gst_object_unref(sinkPad);
     
     // 시그널 연결
-    impl_->onNegotiationNeededId = g_signal_connect(impl_->webrtcbin, 
-        "on-negotiation-needed", G_CALLBACK(Impl::onNegotiationNeeded), this);
-    
-    impl_->onIceCandidateId = g_signal_connect(impl_->webrtcbin, 
-        "on-ice-candidate", G_CALLBACK(Impl::onIceCandidate), this);
-    
-    impl_->onIceGatheringStateId = g_signal_connect(impl_->webrtcbin, 
-        "notify::ice-gathering-state", G_CALLBACK(Impl::onIceGatheringState), this);
-    
-    impl_->onConnectionStateId = g_signal_connect(impl_->webrtcbin, 
-        "notify::connection-state", G_CALLBACK(Impl::onConnectionState), this);
+    connectSignals();
     
     // 버스 메시지 핸들러 추가
-    GstBus* bus = gst_element_get_bus(impl_->pipeline);
-    gst_bus_add_signal_watch(bus);
-    g_signal_connect(bus, "message", G_CALLBACK(Impl::busMessage), this);
-    gst_object_unref(bus);
+    impl_->attachBus(impl_->pipeline, this);
     
     LOG_DEBUG("WebRTC pipeline created successfully");
     
@@ -219,14 +322,7 @@ bool WebRTCPeer::connectToStream(GstElement* udpSrc) {
     LOG_INFO("WebRTC pipeline started successfully, current state: {}", 
              gst_element_state_get_name(state));
     
-    setState(State::CONNECTING);
-    
-    // negotiation-needed 시그널이 발생하지 않을 수 있으므로 수동으로 offer 생성
-    g_idle_add([](gpointer data) -> gboolean {
-        auto* peer = static_cast<WebRTCPeer*>(data);
-        peer->createOffer();
-        return G_SOURCE_REMOVE;
-    }, this);
+    startNegotiation();
     
     return true;
 }
@@ -384,8 +480,18 @@ void WebRTCPeer::Impl::onIceGatheringState(GstElement* element, GParamSpec* pspe
 }
 
 void WebRTCPeer::Impl::onConnectionState(GstElement* element, GParamSpec* pspec, gpointer userData) {
-    (void)element; (void)pspec; (void)userData; // 미사용 매개변수 경고 제거
-    // 연결 상태 변경 처리 (필요시 구현)
+    (void)pspec; // 미사용 매개변수 경고 제거
+    auto* peer = static_cast<WebRTCPeer*>(userData);
+    
+    GstWebRTCPeerConnectionState state;
+    g_object_get(element, "connection-state", &state, nullptr);
+    
+    LOG_DEBUG("Peer {} connection state: {}", peer->config_.peerId, static_cast<int>(state));
+    
+    // DTLS 완료 후에야 RTP가 실제로 전송되므로 이 시점에 첫 프레임 전달
+    if (state == GST_WEBRTC_PEER_CONNECTION_STATE_CONNECTED && peer->mediaReadyCallback_) {
+        peer->mediaReadyCallback_();
+    }
 }
 
 void WebRTCPeer::Impl::onOfferCreated(GstPromise* promise, gpointer userData) {
@@ -477,9 +583,14 @@ WebRTCPeer::Statistics WebRTCPeer::getStatistics() const {
     return stats;
 }
 
-void WebRTCPeer::Impl::busMessage(GstBus* bus, GstMessage* message, gpointer userData) {
-    auto* peer = static_cast<WebRTCPeer*>(userData);
-    
+void WebRTCPeer::Impl::attachBus(GstElement* owner, WebRTCPeer* peer) {
+    busOwnerId = BusDispatcher::getInstance().attach(owner,
+        static_cast<GstMessageType>(GST_MESSAGE_ERROR | GST_MESSAGE_WARNING | GST_MESSAGE_STATE_CHANGED),
+        [peer](GstMessage* message) { busMessage(message, peer); });
+}
+
+// BusDispatcher 스레드에서 호출
+void WebRTCPeer::Impl::busMessage(GstMessage* message, WebRTCPeer* peer) {
     switch (GST_MESSAGE_TYPE(message)) {
         case GST_MESSAGE_ERROR: {
             GError* err;
@@ -500,13 +611,13 @@ void WebRTCPeer::Impl::busMessage(GstBus* bus, GstMessage* message, gpointer use
             break;
         }
         case GST_MESSAGE_STATE_CHANGED: {
-            if (GST_MESSAGE_SRC(message) == GST_OBJECT(peer->impl_->pipeline)) {
-                GstState oldState, newState, pending;
-                gst_message_parse_state_changed(message, &oldState, &newState, &pending);
-                LOG_TRACE("WebRTC pipeline state: {} -> {}", 
-                         gst_element_state_get_name(oldState),
-                         gst_element_state_get_name(newState));
-            }
+            // 디스패처가 소유자(파이프라인 또는 bin) 자신의 상태 변경만 전달
+            GstState oldState, newState, pending;
+            gst_message_parse_state_changed(message, &oldState, &newState, &pending);
+            LOG_TRACE("WebRTC {} state for peer {}: {} -> {}", 
+                     GST_OBJECT_NAME(GST_MESSAGE_SRC(message)), peer->config_.peerId,
+                     gst_element_state_get_name(oldState),
+                     gst_element_state_get_name(newState));
             break;
         }
         default:
@@ -78,16 +78,17 @@ bool WebSocketClient::isConnected() const {
            soup_websocket_connection_get_state(impl_->connection) == SOUP_WEBSOCKET_STATE_OPEN;
 }
 
-void WebSocketClient::sendText(const std::string& message) {
+bool WebSocketClient::sendText(const std::string& message) {
     if (!isConnected()) {
         LOG_ERROR("Cannot send - WebSocket not connected!");
-        return;
+        return false;
     }
     
     LOG_TRACE("Sending WebSocket message: {}", 
               message.length() > 200 ? message.substr(0, 200) + "..." : message);
     
     soup_websocket_connection_send_text(impl_->connection, message.c_str());
+    return true;
 }
 
 void WebSocketClient::sendBinary(const std::vector<uint8_t>& data) {
@@ -0,0 +1,118 @@
+#include "utils/PortAllocator.hpp"
+#include <algorithm>
+
+PortAllocator::PortAllocator(int firstPort, int lastPort, int step)
+    : firstPort_(firstPort), lastPort_(lastPort), step_(std::max(step, 1)) {
+    size_t count = lastPort_ >= firstPort_ ? (lastPort_ - firstPort_) / step_ + 1 : 0;
+
+    slots_.assign(count, SlotState::FREE);
+    pendingReserve_.assign(count, false);
+
+    for (size_t i = 0; i < count; ++i) {
+        freeList_.push_back(static_cast<int>(i));
+    }
+}
+
+int PortAllocator::slotOf(int port) const {
+    if (port < firstPort_ || port > lastPort_ || (port - firstPort_) % step_ != 0) {
+        return -1;
+    }
+    return (port - firstPort_) / step_;
+}
+
+void PortAllocator::reserve(int firstPort, int lastPort) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    bool changed = false;
+    for (int port = std::max(firstPort, firstPort_); port <= std::min(lastPort, lastPort_); ++port) {
+        int slot = slotOf(port);
+        if (slot < 0) continue;
+
+        if (slots_[slot] == SlotState::FREE) {
+            slots_[slot] = SlotState::RESERVED;
+            ++reserved_;
+            changed = true;
+        } else if (slots_[slot] == SlotState::USED) {
+            pendingReserve_[slot] = true;
+        }
+    }
+
+    // 예약은 설정 시점에만 발생하므로 프리 리스트 재구성 비용은 무시
+    if (changed) {
+        freeList_.erase(std::remove_if(freeList_.begin(), freeList_.end(),
+            [this](int slot) { return slots_[slot] != SlotState::FREE; }),
+            freeList_.end());
+    }
+}
+
+void PortAllocator::unreserve(int firstPort, int lastPort) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (int port = std::max(firstPort, firstPort_); port <= std::min(lastPort, lastPort_); ++port) {
+        int slot = slotOf(port);
+        if (slot < 0) continue;
+
+        if (slots_[slot] == SlotState::RESERVED) {
+            slots_[slot] = SlotState::FREE;
+            --reserved_;
+            freeList_.push_back(slot);
+        } else if (slots_[slot] == SlotState::USED) {
+            pendingReserve_[slot] = false;
+        }
+    }
+}
+
+int PortAllocator::allocate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (freeList_.empty()) {
+        return -1;
+    }
+
+    int slot = freeList_.front();
+    freeList_.pop_front();
+
+    slots_[slot] = SlotState::USED;
+    ++used_;
+
+    return firstPort_ + slot * step_;
+}
+
+bool PortAllocator::release(int port) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int slot = slotOf(port);
+    if (slot < 0 || slots_[slot] != SlotState::USED) {
+        return false;
+    }
+
+    --used_;
+
+    if (pendingReserve_[slot]) {
+        pendingReserve_[slot] = false;
+        slots_[slot] = SlotState::RESERVED;
+        ++reserved_;
+    } else {
+        slots_[slot] = SlotState::FREE;
+        freeList_.push_back(slot);
+    }
+
+    return true;
+}
+
+bool PortAllocator::isAllocated(int port) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int slot = slotOf(port);
+    return slot >= 0 && slots_[slot] == SlotState::USED;
+}
+
+PortAllocator::Occupancy PortAllocator::getOccupancy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Occupancy occupancy;
+    occupancy.used = used_;
+    occupancy.reserved = reserved_;
+    occupancy.capacity = slots_.size() - reserved_;
+    return occupancy;
+}
@@ -0,0 +1,225 @@
+#include "video/BranchWatchdog.hpp"
+#include "core/Logger.hpp"
+#include "utils/Performance.hpp"
+#include <algorithm>
+
+namespace {
+
+int64_t steadyNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+struct BranchWatchdog::Watch {
+    Target target;
+    std::atomic<int64_t> lastInputUs{0};
+    std::atomic<int64_t> lastOutputUs{0};
+    Probe input;
+    Probe output;
+
+    // 감시 스레드 전용
+    int64_t armedUs = 0;    // 시작/복구/출력 재개 시각 (이후 timeout 동안은 정지로 보지 않음)
+    int attempts = 0;       // 연속 복구 실패 횟수
+
+    // mutex_ 보호
+    uint64_t stalls = 0;
+    uint64_t recoveries = 0;
+    uint64_t failures = 0;
+    bool suspended = false;
+};
+
+BranchWatchdog::BranchWatchdog(std::chrono::milliseconds timeout, int maxAttempts)
+    : timeout_(timeout), maxAttempts_(std::max(maxAttempts, 1)) {}
+
+BranchWatchdog::~BranchWatchdog() {
+    stop();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& watch : watches_) {
+        detach(watch->input);
+        detach(watch->output);
+    }
+}
+
+int BranchWatchdog::addTarget(const Target& target) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto watch = std::make_unique<Watch>();
+    watch->target = target;
+    watches_.push_back(std::move(watch));
+    return static_cast<int>(watches_.size()) - 1;
+}
+
+void BranchWatchdog::attachInput(int id, GstPad* pad) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id < 0 || id >= static_cast<int>(watches_.size())) return;
+    attach(watches_[id]->input, pad, &watches_[id]->lastInputUs);
+}
+
+void BranchWatchdog::attachOutput(int id, GstPad* pad) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id < 0 || id >= static_cast<int>(watches_.size())) return;
+    attach(watches_[id]->output, pad, &watches_[id]->lastOutputUs);
+}
+
+void BranchWatchdog::attach(Probe& probe, GstPad* pad, std::atomic<int64_t>* lastUs) {
+    detach(probe);
+    if (!pad) return;
+
+    probe.pad = GST_PAD(gst_object_ref(pad));
+    probe.id = gst_pad_add_probe(pad,
+        static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST),
+        bufferProbe, lastUs, nullptr);
+}
+
+void BranchWatchdog::detach(Probe& probe) {
+    if (!probe.pad) return;
+    if (probe.id) gst_pad_remove_probe(probe.pad, probe.id);
+    gst_object_unref(probe.pad);
+    probe.pad = nullptr;
+    probe.id = 0;
+}
+
+GstPadProbeReturn BranchWatchdog::bufferProbe(GstPad* /*pad*/, GstPadProbeInfo* /*info*/, gpointer userData) {
+    static_cast<std::atomic<int64_t>*>(userData)->store(steadyNowUs(), std::memory_order_relaxed);
+    return GST_PAD_PROBE_OK;
+}
+
+void BranchWatchdog::start(Callbacks callbacks) {
+    std::lock_guard<std::mutex> lock(runMutex_);
+    if (running_) return;
+
+    callbacks_ = std::move(callbacks);
+    const int64_t now = steadyNowUs();
+    {
+        std::lock_guard<std::mutex> watchLock(mutex_);
+        for (auto& watch : watches_) {
+            watch->armedUs = now;
+        }
+    }
+
+    running_ = true;
+    thread_ = std::thread(&BranchWatchdog::run, this);
+    LOG_INFO("Branch watchdog started: {} branches, stall timeout {} ms", watches_.size(), timeout_.count());
+}
+
+void BranchWatchdog::stop() {
+    {
+        std::lock_guard<std::mutex> lock(runMutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void BranchWatchdog::run() {
+    // timeout의 1/4 간격으로 확인 (정지 판단 지연은 최대 timeout * 1.25)
+    const auto period = std::max(timeout_ / 4, std::chrono::milliseconds(250));
+
+    std::vector<Watch*> watches;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& watch : watches_) watches.push_back(watch.get());
+    }
+
+    std::unique_lock<std::mutex> lock(runMutex_);
+    while (running_) {
+        wake_.wait_for(lock, period, [this]() { return !running_; });
+        if (!running_) break;
+
+        lock.unlock();
+        for (Watch* watch : watches) {
+            check(*watch, steadyNowUs());
+        }
+        lock.lock();
+    }
+}
+
+void BranchWatchdog::check(Watch& watch, int64_t nowUs) {
+    const int64_t timeoutUs = std::chrono::duration_cast<std::chrono::microseconds>(timeout_).count();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (watch.suspended) return;
+    }
+
+    // 출력이 없어야 정상인 상태(시청자 없음 등)에서는 기준 시각만 갱신
+    if (!callbacks_.expectsOutput(watch.target)) {
+        watch.armedUs = nowUs;
+        return;
+    }
+
+    const int64_t lastOutput = std::max(watch.lastOutputUs.load(std::memory_order_relaxed), watch.armedUs);
+    if (nowUs - lastOutput < timeoutUs) {
+        return;
+    }
+
+    // 입력도 멈췄고 큐도 비어 있으면 상류 정지의 영향 (원인 브랜치가 복구되면 함께 풀림)
+    const int64_t lastInput = watch.lastInputUs.load(std::memory_order_relaxed);
+    if (nowUs - lastInput >= timeoutUs && !callbacks_.isBacklogged(watch.target)) {
+        return;
+    }
+
+    StallEvent event;
+    event.name = watch.target.name;
+    event.camera = watch.target.camera;
+    event.stalledMs = (nowUs - lastOutput) / 1000;
+    LOG_WARNING("Branch {} stalled: no output for {} ms, rebuilding", event.name, event.stalledMs);
+
+    const auto started = std::chrono::steady_clock::now();
+    event.recovered = callbacks_.recover(watch.target);
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+    event.recoveryMs = std::chrono::duration<double, std::milli>(elapsed).count();
+    PerformanceMonitor::getInstance().recordMetric("pipeline.branch_recovery",
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    watch.armedUs = steadyNowUs();
+    watch.attempts = event.recovered ? 0 : watch.attempts + 1;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        watch.stalls++;
+        if (event.recovered) {
+            watch.recoveries++;
+        } else {
+            watch.failures++;
+            watch.suspended = watch.attempts >= maxAttempts_;
+        }
+        event.recoveries = watch.recoveries;
+        event.suspended = watch.suspended;
+    }
+
+    if (event.recovered) {
+        LOG_INFO("Branch {} recovered in {:.0f} ms", event.name, event.recoveryMs);
+    } else if (event.suspended) {
+        LOG_ERROR("Branch {} failed to recover {} times, watchdog suspended for it", event.name, watch.attempts);
+    } else {
+        LOG_ERROR("Branch {} recovery failed, retrying in {} ms", event.name, timeout_.count());
+    }
+
+    if (callbacks_.onStall) {
+        callbacks_.onStall(event);
+    }
+}
+
+std::vector<BranchWatchdog::Health> BranchWatchdog::getHealth() const {
+    const int64_t now = steadyNowUs();
+    auto ageMs = [now](int64_t lastUs) -> int64_t { return lastUs == 0 ? -1 : (now - lastUs) / 1000; };
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Health> health;
+    health.reserve(watches_.size());
+    for (const auto& watch : watches_) {
+        Health entry;
+        entry.name = watch->target.name;
+        entry.outputAgeMs = ageMs(watch->lastOutputUs.load(std::memory_order_relaxed));
+        entry.inputAgeMs = ageMs(watch->lastInputUs.load(std::memory_order_relaxed));
+        entry.stalls = watch->stalls;
+        entry.recoveries = watch->recoveries;
+        entry.failures = watch->failures;
+        entry.suspended = watch->suspended;
+        health.push_back(std::move(entry));
+    }
+    return health;
+}
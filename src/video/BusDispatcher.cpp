@@ -0,0 +1,212 @@
+#include "video/BusDispatcher.hpp"
+#include "core/Logger.hpp"
+
+namespace {
+
+// 소유자 수 * 초당 메시지 수에 비해 충분히 큼 (가득 차면 게시 스레드를 막지 않고 버림)
+constexpr size_t kQueueCapacity = 1024;
+
+// 깨우기 신호를 놓쳐도 이 간격 안에는 큐를 확인
+constexpr auto kIdleWait = std::chrono::milliseconds(100);
+
+}  // namespace
+
+BusDispatcher::BusDispatcher()
+    : queue_(kQueueCapacity),
+      ownerQuark_(g_quark_from_static_string("bus-dispatcher-owner")) {
+    thread_ = std::thread(&BusDispatcher::run, this);
+}
+
+BusDispatcher::~BusDispatcher() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    while (auto event = queue_.tryPop()) {
+        gst_message_unref(event->message);
+    }
+}
+
+uint32_t BusDispatcher::attach(GstElement* owner, GstMessageType mask, Handler handler) {
+    if (!owner || !handler) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint32_t id = nextId_++;
+
+    Owner entry;
+    entry.element = GST_ELEMENT(gst_object_ref(owner));
+    entry.mask = mask;
+    entry.handler = std::move(handler);
+
+    // sync handler가 보기 전에 소유자 표시와 mask를 먼저 반영
+    g_object_set_qdata(G_OBJECT(owner), ownerQuark_, GUINT_TO_POINTER(id));
+    acceptMask_.fetch_or(static_cast<unsigned int>(mask));
+
+    if (GST_IS_PIPELINE(owner)) {
+        entry.bus = gst_element_get_bus(owner);
+        gst_bus_set_sync_handler(entry.bus, syncHandler, GUINT_TO_POINTER(id), nullptr);
+    }
+
+    LOG_DEBUG("Bus dispatcher: {} {} attached as owner {}",
+              entry.bus ? "pipeline" : "bin", GST_OBJECT_NAME(owner), id);
+    owners_.emplace(id, std::move(entry));
+    return id;
+}
+
+void BusDispatcher::detach(uint32_t id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = owners_.find(id);
+    if (it == owners_.end()) {
+        return;
+    }
+
+    Owner owner = std::move(it->second);
+    owners_.erase(it);
+
+    if (owner.bus) {
+        gst_bus_set_sync_handler(owner.bus, nullptr, nullptr, nullptr);
+        gst_object_unref(owner.bus);
+    }
+    if (GPOINTER_TO_UINT(g_object_get_qdata(G_OBJECT(owner.element), ownerQuark_)) == id) {
+        g_object_set_qdata(G_OBJECT(owner.element), ownerQuark_, nullptr);
+    }
+
+    unsigned int mask = 0;
+    for (const auto& [ownerId, entry] : owners_) {
+        mask |= static_cast<unsigned int>(entry.mask);
+    }
+    acceptMask_.store(mask);
+
+    // 핸들러가 소유자 객체를 참조하므로 실행 중이면 끝날 때까지 대기
+    if (std::this_thread::get_id() != thread_.get_id()) {
+        idle_.wait(lock, [this, id]() { return running_ != id; });
+    }
+    lock.unlock();
+
+    gst_object_unref(owner.element);
+}
+
+BusDispatcher::Stats BusDispatcher::getStats() const {
+    Stats stats;
+    stats.posted = posted_.load(std::memory_order_relaxed);
+    stats.filtered = filtered_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.dispatched = dispatched_.load(std::memory_order_relaxed);
+    stats.unrouted = unrouted_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// 메시지를 게시한 스레드(스트리밍 스레드 포함)에서 호출 - 잠금 없이 필터링 후 큐에 넣음
+GstBusSyncReply BusDispatcher::syncHandler(GstBus* /*bus*/, GstMessage* message, gpointer userData) {
+    auto& self = getInstance();
+    self.posted_.fetch_add(1, std::memory_order_relaxed);
+
+    const GstMessageType type = GST_MESSAGE_TYPE(message);
+    bool accept = (self.acceptMask_.load(std::memory_order_relaxed) & static_cast<unsigned int>(type)) != 0;
+
+    // 상태 변경은 엘리먼트마다 게시되므로 소유자(파이프라인/peer bin) 자신의 것만 통과
+    if (accept && type == GST_MESSAGE_STATE_CHANGED) {
+        GstObject* source = GST_MESSAGE_SRC(message);
+        accept = source && g_object_get_qdata(G_OBJECT(source), self.ownerQuark_) != nullptr;
+    }
+
+    if (!accept) {
+        self.filtered_.fetch_add(1, std::memory_order_relaxed);
+        return GST_BUS_DROP;
+    }
+
+    self.post(gst_message_ref(message), GPOINTER_TO_UINT(userData));
+    return GST_BUS_DROP;
+}
+
+void BusDispatcher::post(GstMessage* message, uint32_t busOwner) {
+    if (!queue_.tryPush(Event{message, busOwner})) {
+        if (dropped_.fetch_add(1, std::memory_order_relaxed) == 0) {
+            LOG_WARNING("Bus dispatcher queue full, dropping {} message", GST_MESSAGE_TYPE_NAME(message));
+        }
+        gst_message_unref(message);
+        return;
+    }
+
+    // 소비 스레드가 잠들었을 때만 깨움 (run()의 sleeping_ 설정과 짝을 이루는 fence)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wake_.notify_one();
+    }
+}
+
+void BusDispatcher::run() {
+    while (!stop_) {
+        while (auto event = queue_.tryPop()) {
+            dispatch(*event);
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue_.empty() && !stop_) {
+            wake_.wait_for(lock, kIdleWait);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+void BusDispatcher::dispatch(const Event& event) {
+    GstMessage* message = event.message;
+    Handler handler;
+    uint32_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = resolveOwner(GST_MESSAGE_SRC(message), GST_MESSAGE_TYPE(message), event.busOwner);
+        if (id) {
+            handler = owners_[id].handler;
+            running_ = id;
+        }
+    }
+
+    if (!id) {
+        unrouted_.fetch_add(1, std::memory_order_relaxed);
+        gst_message_unref(message);
+        return;
+    }
+
+    handler(message);
+    dispatched_.fetch_add(1, std::memory_order_relaxed);
+    gst_message_unref(message);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = 0;
+    }
+    idle_.notify_all();
+}
+
+// 게시 엘리먼트부터 부모 방향으로 올라가며 이 종류를 받는 가장 가까운 소유자 검색 (mutex_ 보유 상태)
+// 부모에서 이미 분리된 엘리먼트(제거된 peer bin 등)는 수신한 버스의 소유자로 보냄
+uint32_t BusDispatcher::resolveOwner(GstObject* source, GstMessageType type, uint32_t busOwner) {
+    auto accepts = [this, type](uint32_t id) {
+        auto it = owners_.find(id);
+        return it != owners_.end() && (static_cast<unsigned int>(it->second.mask) & static_cast<unsigned int>(type));
+    };
+
+    GstObject* object = source ? GST_OBJECT(gst_object_ref(source)) : nullptr;
+    while (object) {
+        const uint32_t id = GPOINTER_TO_UINT(g_object_get_qdata(G_OBJECT(object), ownerQuark_));
+        if (id && accepts(id)) {
+            gst_object_unref(object);
+            return id;
+        }
+        GstObject* parent = gst_object_get_parent(object);
+        gst_object_unref(object);
+        object = parent;
+    }
+
+    return accepts(busOwner) ? busOwner : 0;
+}
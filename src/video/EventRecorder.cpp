@@ -122,6 +122,23 @@ size_t EventRecorder::getActiveRecordingCount() const {
     return activeRecordings_.size();
 }
 
+bool EventRecorder::hasActiveEvent() const {
+    std::lock_guard<std::mutex> lock(eventsMutex_);
+    
+    auto now = std::chrono::steady_clock::now();
+    auto window = std::chrono::seconds(config_.recordDuration);
+    for (auto it = recentEvents_.rbegin(); it != recentEvents_.rend(); ++it) {
+        if (now - it->timestamp >= window) {
+            break;
+        }
+        if (it->type != EventType::MANUAL) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
 std::vector<EventRecorder::EventInfo> EventRecorder::getRecentEvents(size_t count) const {
     std::lock_guard<std::mutex> lock(eventsMutex_);
     
@@ -0,0 +1,279 @@
+#include "video/LatencyTracer.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+int64_t steadyNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 캡처 시각 메타 (태그 없음 -> 변환/인코더/페이로더가 출력 버퍼로 복사)
+struct CaptureTimeMeta {
+    GstMeta meta;
+    int64_t captureUs;
+};
+
+GType captureTimeMetaApiType() {
+    static gsize type = 0;
+    if (g_once_init_enter(&type)) {
+        static const gchar* tags[] = { nullptr };
+        GType registered = gst_meta_api_type_register("CaptureTimeMetaAPI", tags);
+        g_once_init_leave(&type, registered);
+    }
+    return type;
+}
+
+gboolean captureTimeMetaInit(GstMeta* meta, gpointer, GstBuffer*) {
+    reinterpret_cast<CaptureTimeMeta*>(meta)->captureUs = 0;
+    return TRUE;
+}
+
+const GstMetaInfo* captureTimeMetaInfo();
+
+gboolean captureTimeMetaTransform(GstBuffer* dest, GstMeta* meta, GstBuffer*, GQuark, gpointer) {
+    auto* source = reinterpret_cast<CaptureTimeMeta*>(meta);
+    auto* copy = reinterpret_cast<CaptureTimeMeta*>(gst_buffer_add_meta(dest, captureTimeMetaInfo(), nullptr));
+    if (!copy) return FALSE;
+    copy->captureUs = source->captureUs;
+    return TRUE;
+}
+
+const GstMetaInfo* captureTimeMetaInfo() {
+    static const GstMetaInfo* info = nullptr;
+    if (g_once_init_enter(&info)) {
+        const GstMetaInfo* registered = gst_meta_register(captureTimeMetaApiType(), "CaptureTimeMeta",
+            sizeof(CaptureTimeMeta), captureTimeMetaInit, nullptr, captureTimeMetaTransform);
+        g_once_init_leave(&info, registered);
+    }
+    return info;
+}
+
+}  // namespace
+
+// 카메라별 PTS -> 캡처 시각 링 버퍼 (기록은 한 스트리밍 스레드, 조회는 여러 스레드)
+struct LatencyTracer::CameraTimeline {
+    struct Entry {
+        std::atomic<uint64_t> pts{GST_CLOCK_TIME_NONE};
+        std::atomic<int64_t> captureUs{0};
+    };
+    static constexpr size_t kSize = 128;
+    std::array<Entry, kSize> entries;
+    uint64_t head = 0;
+
+    void stamp(GstClockTime pts, int64_t captureUs) {
+        auto& entry = entries[head++ % kSize];
+        entry.pts.store(GST_CLOCK_TIME_NONE, std::memory_order_relaxed);
+        entry.captureUs.store(captureUs, std::memory_order_relaxed);
+        entry.pts.store(pts, std::memory_order_release);
+    }
+
+    int64_t find(GstClockTime pts) const {
+        for (const auto& entry : entries) {
+            if (entry.pts.load(std::memory_order_acquire) == pts) {
+                return entry.captureUs.load(std::memory_order_relaxed);
+            }
+        }
+        return -1;
+    }
+};
+
+struct LatencyTracer::Point {
+    std::string name;
+    GstPad* pad = nullptr;
+    gulong probeId = 0;
+    CameraTimeline* timeline = nullptr;
+    bool recordsTimeline = false;
+    Histogram latencyUs;
+    std::atomic<uint64_t> unmatched{0};
+
+    ~Point() {
+        if (pad) gst_object_unref(pad);
+    }
+};
+
+LatencyTracer::LatencyTracer(int cameras) {
+    for (int i = 0; i < cameras; ++i) {
+        timelines_.push_back(std::make_unique<CameraTimeline>());
+    }
+}
+
+LatencyTracer::~LatencyTracer() {
+    detachAll();
+}
+
+bool LatencyTracer::addCapturePoint(GstPad* pad, int camera) {
+    if (!pad || camera < 0 || camera >= static_cast<int>(timelines_.size())) {
+        return false;
+    }
+
+    auto point = std::make_shared<Point>();
+    point->name = "cam" + std::to_string(camera) + ".capture";
+    point->pad = static_cast<GstPad*>(gst_object_ref(pad));
+    point->probeId = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER,
+        captureProbe, nullptr, nullptr);
+
+    if (point->probeId == 0) {
+        LOG_ERROR("Failed to add capture probe for camera {}", camera);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    capturePoints_.push_back(point);
+    return true;
+}
+
+bool LatencyTracer::addMeasurePoint(GstPad* pad, int camera, const std::string& name, bool recordsTimeline) {
+    if (!pad || camera < 0 || camera >= static_cast<int>(timelines_.size())) {
+        return false;
+    }
+
+    auto point = std::make_shared<Point>();
+    point->name = name;
+    point->pad = static_cast<GstPad*>(gst_object_ref(pad));
+    point->timeline = timelines_[camera].get();
+    point->recordsTimeline = recordsTimeline;
+
+    // 프로브가 실행 중일 수 있으므로 Point 수명은 프로브 해제 시점까지 연장
+    point->probeId = gst_pad_add_probe(pad,
+        static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST),
+        measureProbe,
+        new std::shared_ptr<Point>(point),
+        [](gpointer data) { delete static_cast<std::shared_ptr<Point>*>(data); });
+
+    if (point->probeId == 0) {
+        LOG_ERROR("Failed to add latency probe: {}", name);
+        return false;
+    }
+
+    std::shared_ptr<Point> replaced;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& slot = points_[name];
+        replaced = std::move(slot);
+        slot = point;
+    }
+    if (replaced) {
+        detachPoint(*replaced);
+    }
+
+    LOG_DEBUG("Added latency point: {}", name);
+    return true;
+}
+
+void LatencyTracer::removePoint(const std::string& name, GstPad* pad) {
+    std::shared_ptr<Point> point;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = points_.find(name);
+        if (it == points_.end() || (pad && it->second->pad != pad)) return;
+        point = std::move(it->second);
+        points_.erase(it);
+    }
+    detachPoint(*point);
+}
+
+void LatencyTracer::detachAll() {
+    std::unordered_map<std::string, std::shared_ptr<Point>> points;
+    std::vector<std::shared_ptr<Point>> capturePoints;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        points.swap(points_);
+        capturePoints.swap(capturePoints_);
+    }
+
+    for (auto& point : capturePoints) detachPoint(*point);
+    for (auto& [name, point] : points) detachPoint(*point);
+}
+
+void LatencyTracer::detachPoint(Point& point) {
+    if (point.pad && point.probeId) {
+        gst_pad_remove_probe(point.pad, point.probeId);
+        point.probeId = 0;
+    }
+}
+
+std::vector<LatencyTracer::PointReport> LatencyTracer::getReport() const {
+    std::vector<PointReport> report;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        report.reserve(points_.size());
+        for (const auto& [name, point] : points_) {
+            PointReport entry;
+            entry.name = name;
+            entry.latencyUs = point->latencyUs.summarize();
+            entry.unmatched = point->unmatched.load(std::memory_order_relaxed);
+            report.push_back(std::move(entry));
+        }
+    }
+
+    std::sort(report.begin(), report.end(),
+        [](const PointReport& a, const PointReport& b) { return a.name < b.name; });
+    return report;
+}
+
+void LatencyTracer::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [name, point] : points_) {
+        point->latencyUs.reset();
+        point->unmatched.store(0, std::memory_order_relaxed);
+    }
+}
+
+GstPadProbeReturn LatencyTracer::captureProbe(GstPad*, GstPadProbeInfo* info, gpointer) {
+    GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    if (!buffer || gst_buffer_get_meta(buffer, captureTimeMetaApiType())) {
+        return GST_PAD_PROBE_OK;
+    }
+
+    // 메타 추가에는 쓰기 가능한 버퍼가 필요 (메모리는 공유되는 얕은 복사)
+    buffer = gst_buffer_make_writable(buffer);
+    GST_PAD_PROBE_INFO_DATA(info) = buffer;
+
+    auto* meta = reinterpret_cast<CaptureTimeMeta*>(
+        gst_buffer_add_meta(buffer, captureTimeMetaInfo(), nullptr));
+    if (meta) {
+        meta->captureUs = steadyNowUs();
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn LatencyTracer::measureProbe(GstPad*, GstPadProbeInfo* info, gpointer userData) {
+    Point& point = **static_cast<std::shared_ptr<Point>*>(userData);
+    int64_t now = steadyNowUs();
+
+    // 버퍼 리스트는 첫 버퍼 (같은 프레임의 RTP 패킷들) 기준
+    GstBuffer* buffer = nullptr;
+    if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+        GstBufferList* list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+        if (list && gst_buffer_list_length(list) > 0) {
+            buffer = gst_buffer_list_get(list, 0);
+        }
+    } else {
+        buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    }
+    if (!buffer) return GST_PAD_PROBE_OK;
+
+    int64_t captureUs = -1;
+    auto* meta = reinterpret_cast<CaptureTimeMeta*>(gst_buffer_get_meta(buffer, captureTimeMetaApiType()));
+
+    if (meta) {
+        captureUs = meta->captureUs;
+        if (point.recordsTimeline && GST_BUFFER_PTS_IS_VALID(buffer)) {
+            point.timeline->stamp(GST_BUFFER_PTS(buffer), captureUs);
+        }
+    } else if (GST_BUFFER_PTS_IS_VALID(buffer)) {
+        captureUs = point.timeline->find(GST_BUFFER_PTS(buffer));
+    }
+
+    if (captureUs > 0 && now >= captureUs) {
+        point.latencyUs.record(static_cast<uint64_t>(now - captureUs));
+    } else {
+        point.unmatched.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return GST_PAD_PROBE_OK;
+}
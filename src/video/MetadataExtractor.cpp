@@ -0,0 +1,256 @@
+#include "video/MetadataExtractor.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+#ifdef HAVE_DEEPSTREAM
+#include <gstnvdsmeta.h>
+#endif
+
+namespace {
+
+// 깨우기 신호를 놓쳐도 이 간격 안에는 링을 확인
+constexpr auto kIdleWait = std::chrono::milliseconds(100);
+
+}  // namespace
+
+struct MetadataExtractor::Camera {
+    Camera(MetadataExtractor* owner, int index) : owner(owner), index(index), ring(kQueueFrames) {}
+
+    MetadataExtractor* owner;
+    const int index;
+    SpscRing<Frame> ring;
+
+    // probeMutex_ 보호
+    GstPad* pad = nullptr;
+    gulong probeId = 0;
+
+    std::atomic<int> interval{0};   // 건너뛸 프레임 수 (설정 적용 스레드에서 변경)
+
+    // 스트리밍 스레드 전용
+    uint64_t sequence = 0;
+
+    // 스트리밍 스레드에서 갱신
+    std::atomic<uint64_t> overruns{0};
+    std::atomic<uint64_t> truncated{0};
+    std::atomic<uint64_t> missingMeta{0};
+
+    // 워커 스레드에서 갱신
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> objects{0};
+};
+
+MetadataExtractor::MetadataExtractor(int cameras, bool batchMeta)
+    : batchMeta_(batchMeta) {
+    for (int i = 0; i < cameras; ++i) {
+        cameras_.push_back(std::make_unique<Camera>(this, i));
+    }
+}
+
+MetadataExtractor::~MetadataExtractor() {
+    stop();
+    std::lock_guard<std::mutex> lock(probeMutex_);
+    for (auto& camera : cameras_) {
+        detach(*camera);
+    }
+}
+
+// 이전 OSD 엘리먼트가 정지된 뒤에 호출 (링의 생산자는 항상 하나)
+bool MetadataExtractor::attach(int camera, GstElement* element, const char* padName) {
+    if (camera < 0 || camera >= static_cast<int>(cameras_.size()) || !element) {
+        return false;
+    }
+
+    GstPad* pad = gst_element_get_static_pad(element, padName);
+    if (!pad) {
+        LOG_ERROR("Pad not found: {} on element {}", padName, GST_ELEMENT_NAME(element));
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(probeMutex_);
+    Camera& entry = *cameras_[camera];
+    detach(entry);
+
+    entry.probeId = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, bufferProbe, &entry, nullptr);
+    if (entry.probeId == 0) {
+        LOG_ERROR("Failed to add metadata probe to {}:{}", GST_ELEMENT_NAME(element), padName);
+        gst_object_unref(pad);
+        return false;
+    }
+    entry.pad = pad;
+    return true;
+}
+
+void MetadataExtractor::detach(Camera& camera) {
+    if (!camera.pad) return;
+    if (camera.probeId) gst_pad_remove_probe(camera.pad, camera.probeId);
+    gst_object_unref(camera.pad);
+    camera.pad = nullptr;
+    camera.probeId = 0;
+}
+
+void MetadataExtractor::setInterval(int camera, int interval) {
+    if (camera < 0 || camera >= static_cast<int>(cameras_.size())) return;
+    cameras_[camera]->interval = std::max(interval, 0);
+}
+
+void MetadataExtractor::start(FrameCallback callback) {
+    if (running_) return;
+
+    callback_ = std::move(callback);
+    running_ = true;
+    thread_ = std::thread(&MetadataExtractor::run, this);
+    LOG_INFO("Metadata extractor started: {} cameras, {} frames x {} objects per camera",
+             cameras_.size(), kQueueFrames, kMaxObjects);
+}
+
+void MetadataExtractor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    for (const auto& camera : cameras_) {
+        Stats stats = getStats(camera->index);
+        LOG_INFO("Metadata extractor camera {}: {} frames, {} objects, {} overruns, {} truncated, {} without meta",
+                 camera->index, stats.frames, stats.objects, stats.overruns, stats.truncated, stats.missingMeta);
+    }
+}
+
+MetadataExtractor::Stats MetadataExtractor::getStats(int camera) const {
+    Stats stats;
+    if (camera < 0 || camera >= static_cast<int>(cameras_.size())) {
+        return stats;
+    }
+    const Camera& entry = *cameras_[camera];
+    stats.frames = entry.frames.load(std::memory_order_relaxed);
+    stats.objects = entry.objects.load(std::memory_order_relaxed);
+    stats.overruns = entry.overruns.load(std::memory_order_relaxed);
+    stats.truncated = entry.truncated.load(std::memory_order_relaxed);
+    stats.missingMeta = entry.missingMeta.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// 스트리밍 스레드 - 메타를 복사만 하고 프레임은 항상 통과
+GstPadProbeReturn MetadataExtractor::bufferProbe(GstPad* /*pad*/, GstPadProbeInfo* info, gpointer userData) {
+    auto* camera = static_cast<Camera*>(userData);
+    camera->owner->extract(*camera, GST_PAD_PROBE_INFO_BUFFER(info));
+    return GST_PAD_PROBE_OK;
+}
+
+void MetadataExtractor::extract(Camera& camera, GstBuffer* buffer) {
+    const uint64_t skip = static_cast<uint64_t>(camera.interval.load(std::memory_order_relaxed));
+    if (camera.sequence++ % (skip + 1) != 0) {
+        return;
+    }
+
+#ifdef HAVE_DEEPSTREAM
+    NvDsBatchMeta* batchMeta = batchMeta_ ? gst_buffer_get_nvds_batch_meta(buffer) : nullptr;
+    if (batchMeta) {
+        for (NvDsMetaList* l_frame = batchMeta->frame_meta_list; l_frame != nullptr; l_frame = l_frame->next) {
+            auto* frameMeta = static_cast<NvDsFrameMeta*>(l_frame->data);
+            if (!frameMeta) continue;
+
+            Frame* frame = acquire(camera);
+            if (!frame) return;
+
+            frame->camera = camera.index;
+            frame->pts = frameMeta->buf_pts;
+            frame->frameNumber = static_cast<uint64_t>(frameMeta->frame_num);
+            frame->objectCount = 0;
+            frame->truncated = 0;
+
+            for (NvDsMetaList* l_obj = frameMeta->obj_meta_list; l_obj != nullptr; l_obj = l_obj->next) {
+                auto* objMeta = static_cast<NvDsObjectMeta*>(l_obj->data);
+                if (!objMeta) continue;
+                if (frame->objectCount == kMaxObjects) {
+                    frame->truncated++;
+                    continue;
+                }
+                Object& object = frame->objects[frame->objectCount++];
+                object.left = objMeta->rect_params.left;
+                object.top = objMeta->rect_params.top;
+                object.width = objMeta->rect_params.width;
+                object.height = objMeta->rect_params.height;
+                object.confidence = objMeta->confidence;
+                object.classId = objMeta->class_id;
+                object.trackId = objMeta->object_id;
+            }
+            if (frame->truncated) {
+                camera.truncated.fetch_add(frame->truncated, std::memory_order_relaxed);
+            }
+            publish(camera);
+        }
+        return;
+    }
+    if (batchMeta_) {
+        camera.missingMeta.fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+
+    // 메타가 없으면 프레임 시각만 전달 (분석 스텁 / 메타 누락)
+    Frame* frame = acquire(camera);
+    if (!frame) return;
+    frame->camera = camera.index;
+    frame->pts = GST_BUFFER_PTS(buffer);
+    frame->frameNumber = camera.sequence;
+    frame->objectCount = 0;
+    frame->truncated = 0;
+    publish(camera);
+}
+
+MetadataExtractor::Frame* MetadataExtractor::acquire(Camera& camera) {
+    Frame* frame = camera.ring.acquire();
+    if (!frame && camera.overruns.fetch_add(1, std::memory_order_relaxed) == 0) {
+        LOG_WARNING("Metadata queue for camera {} full, dropping records (analytics too slow)", camera.index);
+    }
+    return frame;
+}
+
+void MetadataExtractor::publish(Camera& camera) {
+    camera.ring.publish();
+
+    // 워커가 잠들었을 때만 깨움 (run()의 sleeping_ 설정과 짝을 이루는 fence)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wake_.notify_one();
+    }
+}
+
+void MetadataExtractor::run() {
+    auto allEmpty = [this]() {
+        for (const auto& camera : cameras_) {
+            if (!camera->ring.empty()) return false;
+        }
+        return true;
+    };
+
+    while (running_) {
+        bool idle = true;
+        for (auto& camera : cameras_) {
+            // 한 카메라가 워커를 독점하지 않도록 한 바퀴에 링 크기까지만 처리
+            for (size_t n = 0; n < kQueueFrames; ++n) {
+                const Frame* frame = camera->ring.front();
+                if (!frame) break;
+                if (callback_) callback_(*frame);
+                camera->frames.fetch_add(1, std::memory_order_relaxed);
+                camera->objects.fetch_add(frame->objectCount, std::memory_order_relaxed);
+                camera->ring.release();
+                idle = false;
+            }
+        }
+        if (!idle) continue;
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (allEmpty() && running_) {
+            wake_.wait_for(lock, kIdleWait);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
@@ -1,12 +1,31 @@
 #include "video/Pipeline.hpp"
 #include "video/PipelineBuilder.hpp"
+#include "video/PipelineProfile.hpp"
+#include "video/PipelineText.hpp"
+#include "video/LatencyTracer.hpp"
+#include "video/TimestampOverlay.hpp"
+#include "video/BusDispatcher.hpp"
 #include "core/Logger.hpp"
+#include "utils/Histogram.hpp"
+#include "utils/Performance.hpp"
+#include "utils/PortAllocator.hpp"
+#include "utils/ThreadPool.hpp"
 #include <gst/gstpad.h>
-#include <gst/gstbus.h>
+#include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
+#include <gst/video/video.h>
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <sstream>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
 #include <future>
+#include <map>
+#include <regex>
 
 enum ProcessType {
     SENDER = 0,
@@ -14,42 +33,457 @@ enum ProcessType {
     EVENT_RECORDER = 2
 };
 
+namespace {
+
+int64_t steadyNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 캐시할 GOP의 최대 RTP 패킷 수 (초과 시 다음 키프레임까지 캐시 비움)
+constexpr size_t kMaxGopCachePackets = 2048;
+
+// 연결 완료 신호가 오지 않는 peer도 이 시간 이후에는 스트림 전달
+constexpr int64_t kPrimeFallbackUs = 5'000'000;
+
+// 공유 스케일러 출력의 프레임 분주 상태 (해당 패드의 스트리밍 스레드만 접근)
+struct FrameDivider {
+    int fpsNum;
+    int fpsDen;
+    uint64_t ratio = 1;
+    GstClockTime next = GST_CLOCK_TIME_NONE;
+};
+
+// PTS 격자 기준으로 period마다 한 버퍼만 통과 (상류에서 프레임이 빠져도 목표 레이트 유지)
+// 입력 지터를 감안해 반 주기 이내로 일찍 온 버퍼는 통과, 격자에서 크게 벗어나면 재설정
+bool passesFrameInterval(GstClockTime& next, GstClockTime period, GstClockTime pts) {
+    if (!GST_CLOCK_TIME_IS_VALID(pts) || period == 0) {
+        return true;
+    }
+    if (GST_CLOCK_TIME_IS_VALID(next) && pts + 2 * period > next && pts < next + period) {
+        if (pts + period / 2 < next) {
+            return false;
+        }
+        next += period;
+        return true;
+    }
+    next = pts + period;
+    return true;
+}
+
+// 종료 시 peer 브랜치 정리 스레드 수와 단계별 최대 대기 시간
+constexpr size_t kTeardownThreads = 4;
+constexpr auto kPeerTeardownTimeout = std::chrono::seconds(2);
+constexpr auto kDrainTimeout = std::chrono::milliseconds(1500);
+
+// stop()의 단계별 소요 시간 (종료 로그용)
+struct ShutdownReport {
+    double probesMs = 0.0;
+    double peersMs = 0.0;
+    double drainMs = 0.0;       // 소스 EOS 전달 대기
+    double nullMs = 0.0;        // NULL 전환 및 참조 해제
+    double totalMs = 0.0;
+    size_t peers = 0;
+    bool drained = false;       // 모든 카메라 소스가 EOS로 정상 종료됨
+};
+
+}  // namespace
+
+struct Pipeline::StreamPrimer {
+    std::string peerId;
+    GstPad* teePad = nullptr;
+    int64_t attachedAtUs = 0;
+    std::atomic<int64_t> requestedAtUs{0};
+    std::atomic<bool> primed{false};
+    bool keyframeRequested = false;  // GopCache::mutex 보호
+    
+    ~StreamPrimer() {
+        if (teePad) gst_object_unref(teePad);
+    }
+};
+
+struct Pipeline::StreamMetrics {
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> buffers{0};
+    std::atomic<uint64_t> sends{0};
+    std::atomic<uint64_t> lists{0};
+    std::atomic<uint64_t> overruns{0};
+};
+
+// 캐시 잠금 밖에서 peer 브랜치로 전달할 GOP (버퍼/패드 참조 보유)
+struct GopReplay {
+    GstPad* pad;
+    std::vector<GstBuffer*> buffers;
+};
+
+// stream tee 하나에 대한 최근 GOP 캐시와 첫 프레임 대기 중인 브랜치 목록
+struct GopCache {
+    std::string teeName;
+    int64_t maxAgeUs = 1'000'000;
+    bool replayAsList = false;  // 캐시된 GOP를 버퍼 리스트 하나로 전달 (udpsink에서 sendmmsg 한 번)
+    
+    std::atomic<int> subscribers{0};  // 연결된 peer 수 (0이면 캐시하지 않음)
+    
+    std::mutex mutex;
+    std::vector<GstBuffer*> buffers;
+    int64_t gopStartUs = 0;
+    bool lastWasDelta = true;
+    std::vector<std::shared_ptr<Pipeline::StreamPrimer>> pending;
+    
+    ~GopCache() { clear(); }
+    
+    void clear() {
+        for (GstBuffer* buffer : buffers) {
+            gst_buffer_unref(buffer);
+        }
+        buffers.clear();
+    }
+    
+    void remove(const std::shared_ptr<Pipeline::StreamPrimer>& primer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.erase(std::remove(pending.begin(), pending.end(), primer), pending.end());
+    }
+};
+
+// 카메라 하나의 처리 통계
+// 카운터는 스트리밍 스레드에서만 갱신하고 getStatistics()는 atomic 읽기만 수행
+struct CameraStats {
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<double> currentFps{0.0};
+    std::atomic<double> averageFps{0.0};
+    std::atomic<double> jitterUs{0.0};        // 프레임 간격 변화량의 지수 평균 (RFC 3550 방식)
+    std::atomic<uint64_t> unmatchedFrames{0};  // 소스 시각을 찾지 못한 프레임
+    Histogram intervalUs;
+    Histogram processingUs;                    // 소스 tee -> OSD 처리 시간
+    
+    // 프레임 집계 위치: OSD가 있으면 OSD, 없으면 소스 tee (추론 브랜치 재구성 시 갱신)
+    std::atomic<bool> countAtSource{true};
+    
+    // 프레임 집계 스레드 전용 상태
+    int64_t windowStartUs = 0;
+    uint64_t windowFrames = 0;
+    int64_t lastFrameUs = 0;
+    int64_t lastIntervalUs = -1;
+    
+    // 소스 tee 통과 시각 (PTS 기준, OSD 프로브에서 조회)
+    struct SourceStamp {
+        std::atomic<uint64_t> pts{GST_CLOCK_TIME_NONE};
+        std::atomic<int64_t> arrivedUs{0};
+    };
+    static constexpr size_t kTimelineSize = 64;
+    std::array<SourceStamp, kTimelineSize> timeline;
+    uint64_t timelineHead = 0;  // 소스 tee 스트리밍 스레드 전용
+    
+    void stampSource(GstClockTime pts, int64_t nowUs) {
+        auto& slot = timeline[timelineHead++ % kTimelineSize];
+        slot.pts.store(GST_CLOCK_TIME_NONE, std::memory_order_relaxed);
+        slot.arrivedUs.store(nowUs, std::memory_order_relaxed);
+        slot.pts.store(pts, std::memory_order_release);
+    }
+    
+    int64_t findSource(GstClockTime pts) const {
+        for (const auto& slot : timeline) {
+            if (slot.pts.load(std::memory_order_acquire) == pts) {
+                return slot.arrivedUs.load(std::memory_order_relaxed);
+            }
+        }
+        return -1;
+    }
+    
+    void countFrame(int64_t nowUs) {
+        uint64_t total = frames.fetch_add(1, std::memory_order_relaxed) + 1;
+        
+        if (lastFrameUs > 0) {
+            int64_t interval = nowUs - lastFrameUs;
+            intervalUs.record(static_cast<uint64_t>(std::max<int64_t>(interval, 0)));
+            
+            if (lastIntervalUs >= 0) {
+                double delta = static_cast<double>(std::abs(interval - lastIntervalUs));
+                double jitter = jitterUs.load(std::memory_order_relaxed);
+                jitterUs.store(jitter + (delta - jitter) / 16.0, std::memory_order_relaxed);
+            }
+            lastIntervalUs = interval;
+        }
+        lastFrameUs = nowUs;
+        
+        // 1초 창 단위 FPS
+        if (windowStartUs == 0) {
+            windowStartUs = nowUs;
+            windowFrames = total;
+            return;
+        }
+        
+        int64_t elapsed = nowUs - windowStartUs;
+        if (elapsed >= 1'000'000) {
+            double fps = static_cast<double>(total - windowFrames) * 1'000'000.0 / elapsed;
+            double average = averageFps.load(std::memory_order_relaxed);
+            
+            currentFps.store(fps, std::memory_order_relaxed);
+            averageFps.store(average == 0.0 ? fps : average * 0.9 + fps * 0.1, std::memory_order_relaxed);
+            
+            windowStartUs = nowUs;
+            windowFrames = total;
+        }
+    }
+};
+
 struct Pipeline::Impl {
+    std::unique_ptr<SnapshotCache> snapshots;  // appsink 콜백이 참조하므로 pipeline보다 나중에 정리
     GstPtr<GstElement> pipeline;
+    std::unique_ptr<ThreadPool> teardownPool;  // pipeline보다 먼저 정리되도록 바로 뒤에 선언
+    std::unique_ptr<BranchWatchdog> watchdog;  // 감시 스레드가 재구성에 teardownPool을 사용하므로 그보다 먼저 정리
     PipelineConfig config;
     std::unordered_map<std::string, GstElement*> elements;
     std::unordered_map<std::string, gulong> probeIds;
     std::unordered_map<std::string, ProbeCallback> probeCallbacks;
     
+    // config.webrtcConfig, elements, probeIds/probeCallbacks 보호 (짧게만 보유, 다른 락을 잡지 않음)
+    // 설정 스레드/감시 스레드의 갱신과 signaling/heartbeat 스레드의 조회 사이 경쟁 방지
+    // config.webrtcConfig.video 갱신은 branchMutex도 함께 보유하므로 branchMutex 보유 측은 락 없이 읽어도 됨
+    mutable std::mutex stateMutex;
+    
+    // 캡처 버퍼 협상 결과 (스트리밍 스레드에서 갱신)
+    mutable std::mutex captureMutex;
+    std::vector<CaptureReport> captureReports;
+    
+    // 브랜치 재구성 직렬화 (설정 변경과 정지 복구가 같은 브랜치를 동시에 교체하지 않도록)
+    std::mutex branchMutex;
+    std::vector<std::array<int, 5>> watchIds;  // 카메라/브랜치 -> 감시 대상 (-1 = 감시 안 함)
+    StallCallback stallCallback;
+    
+    // 분석 ON/OFF: 추론 앞 valve와 원본 프레임 우회 경로를 input-selector로 전환 (analysis_bypass 설정 시)
+    struct AnalysisControl {
+        GstElement* inferValve = nullptr;
+        GstElement* bypassValve = nullptr;
+        GstElement* bypassCaps = nullptr;   // 우회 출력을 추론 출력 caps에 맞춤 (인코더 재협상 방지)
+        GstElement* selector = nullptr;
+        GstPad* inferOutput = nullptr;      // 추론 출구 마커 src
+        GstPad* inferPad = nullptr;         // selector 입력 (추론 출력)
+        GstPad* bypassPad = nullptr;        // selector 입력 (우회 경로)
+        std::atomic<bool> enabled{true};
+        std::atomic<uint64_t> generation{0};  // 전환 요청마다 증가 (대기 중인 전환 프로브 무효화)
+        std::mutex switchMutex;             // switchProbe 보호 (전환 프로브의 스트리밍 스레드와 공유)
+        gulong switchProbe = 0;             // inferOutput의 대기 중인 전환 프로브 (0 = 없음)
+        int interval = -1;                  // nvinfer interval (-1 = 설정 파일 값 유지, branchMutex 보호)
+        int rateInterval = -1;              // 추론 프레임레이트 상한에서 환산한 interval (-1 = 상한 없음, branchMutex 보호)
+        
+        ~AnalysisControl() { release(); }
+        void release();
+        void armSwitch(GstPadProbeType type, bool resume, uint64_t generation);
+        void cancelSwitch();
+    };
+    // 대기 중인 전환 (resume: 추론 출력 첫 버퍼, bypass: 추론 출력 caps 협상 시 완료)
+    struct AnalysisSwitch {
+        AnalysisControl* control;
+        uint64_t generation;
+        bool resume;
+    };
+    std::vector<std::unique_ptr<AnalysisControl>> analysis;  // create()에서 카메라 수만큼 생성
+    static std::string inferValveName(int camera) { return "infer_valve_" + std::to_string(camera); }
+    static std::string inferBypassName(int camera) { return "infer_bypass_" + std::to_string(camera); }
+    static std::string inferBypassCapsName(int camera) { return "infer_bypass_caps_" + std::to_string(camera); }
+    static std::string inferSelectorName(int camera) { return "infer_select_" + std::to_string(camera); }
+    bool bypassesAnalysis(int camera) const;
+    void setupAnalysisControl(int camera);
+    void bypassAnalysis(int camera, AnalysisControl& control, uint64_t generation);
+    void resumeAnalysis(AnalysisControl& control, uint64_t generation);
+    static bool completeBypass(AnalysisControl& control, GstCaps* caps);
+    static void completeResume(AnalysisControl& control);
+    static GstPadProbeReturn analysisSwitchProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    int effectiveInferenceInterval(int camera) const;
+    int applyInferenceInterval(int camera);
+    
+    // 프레임레이트 상한 (rate_governor): caps는 그대로 두고 PTS 간격으로 버퍼만 버림 (peer 재협상 없음)
+    struct RateLimiter {
+        std::atomic<int> fps{0};                    // 0 = 제한 없음
+        GstClockTime next = GST_CLOCK_TIME_NONE;    // 다음 통과 PTS (스트리밍 스레드 전용)
+        std::atomic<uint64_t> dropped{0};
+        GstPad* pad = nullptr;                      // branchMutex 보호
+        gulong probeId = 0;
+        
+        // 인코더 입력이면 caps 프레임레이트 기준의 비트레이트/키프레임 간격을 실제 통과 비율만큼 보정
+        // (PLAYING 중 변경 가능한 guint 속성만, detach 시 설정값으로 복원)
+        struct EncoderProperty {
+            const char* name;
+            guint base;                             // 설정값
+            bool perSecond;                         // true: 초당 값 (비트레이트), false: 프레임 수 (키프레임 간격)
+        };
+        std::mutex encoderMutex;
+        GstElement* encoder = nullptr;              // encoderMutex 보호
+        std::vector<EncoderProperty> encoderProperties;  // encoderMutex 보호
+        std::atomic<int> scaledFps{-1};             // 보정에 반영한 상한 (-1 = 아직 없음)
+        
+        ~RateLimiter() { detach(); }
+        void attach(GstPad* target, GstElement* targetEncoder = nullptr);  // target 참조를 넘겨받음
+        void detach();
+        void scaleEncoder(GstPad* input, int limit);
+    };
+    struct RateControl {
+        RateLimits limits;
+        RateLimiter source;                         // 소스 tee 입력
+        RateLimiter encoders[2];                    // 라이브 인코더 입력 (StreamType 순서)
+    };
+    std::vector<std::unique_ptr<RateControl>> rates;  // create()에서 카메라 수만큼 생성
+    static GstPadProbeReturn rateLimitProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    void setupRateControl(int camera);
+    void attachEncoderLimiter(int camera, StreamType type);
+    int inferRateInterval(int camera, const RateLimits& limits);
+    
     // 동적 스트림 관리
-    std::unordered_map<std::string, DynamicStreamInfo> dynamicStreams;
-    std::set<int> usedPorts;
+    std::unordered_map<std::string, std::shared_ptr<DynamicStreamInfo>> dynamicStreams;
+    std::unordered_map<std::string, int> teeSubscribers;  // tee 이름 -> 연결된 peer 수
+    std::unordered_map<std::string, std::shared_ptr<GopCache>> gopCaches;  // tee 이름 -> GOP 캐시
+    std::unique_ptr<PortAllocator> ports;
     std::mutex streamMutex;
     
+    // tee별 브랜치 연결/해제 작업 (IDLE 프로브에서 일괄 처리)
+    struct BranchOp {
+        enum Kind { ATTACH, DETACH } kind;
+        std::shared_ptr<DynamicStreamInfo> info;
+        CompletionCallback done;
+    };
+    struct TeeOpQueue {
+        std::vector<BranchOp> ops;
+        bool probeArmed = false;
+    };
+    struct IdleProbeData {
+        Impl* impl;
+        std::string teeName;
+    };
+    std::mutex opsMutex;
+    std::unordered_map<std::string, TeeOpQueue> teeOps;
+    
     // Tee 엘리먼트들 (스트림 분기용)
     std::unordered_map<std::string, GstElement*> teeElements;
     
-    // 통계
-    mutable std::mutex statsMutex;
-    std::unordered_map<CameraDevice, Statistics> stats;
+    // 통계 (카메라 인덱스별, create() 이후 크기 고정)
+    std::vector<std::unique_ptr<CameraStats>> stats;
+    std::unique_ptr<LatencyTracer> latencyTracer;  // latency_tracing 설정 시에만 생성
     
     // 상태
     std::atomic<bool> running{false};
-    GstState currentState{GST_STATE_NULL};
+    std::atomic<GstState> currentState{GST_STATE_NULL};  // 버스 디스패처 스레드에서 갱신
+    uint32_t busOwnerId = 0;  // BusDispatcher 등록 ID
     
     // 헬퍼 함수들
     std::string buildPipelineString();
+    int recordPort(int cameraIndex) const;
+    bool isPinnedPort(int port, int exceptCamera) const;
+    bool gatesEncoder(int cameraIndex, StreamType type) const;
+    static std::string nameFirstElement(const std::string& chain, const std::string& name);
+    static std::string nameElement(const std::string& chain, const std::string& factory, const std::string& name);
+    static std::string clockOverlayName(const std::string& src, int camera);
+    static std::string captureSourceName(int camera) { return "capture_src_" + std::to_string(camera); }
+    void setupCapture(int camera);
+    static GstPadProbeReturn captureProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    struct CaptureProbeContext {
+        Impl* impl;
+        int camera;
+        unsigned poolMin;
+        unsigned poolMax;
+    };
+    void installTimestampOverlay(int camera);
+    static std::string latencyPointName(const DynamicStreamInfo& info);
+    static GstPad* findEncoderSrcPad(GstElement* tee);
+    static std::string streamTeeName(const DynamicStreamInfo& info);
+    void acquireEncoder(const DynamicStreamInfo& info);
+    void releaseEncoder(const DynamicStreamInfo& info);
+    void setEncoderActive(const DynamicStreamInfo& info, bool active);
     int get_udp_port(ProcessType process, CameraDevice device, StreamType stream, int index);
-    bool setupOsdProbes();
+    bool setupStatsProbes();
+    void attachSourceStatsProbe(int camera);
+    void attachOsdStatsProbe(int camera);
+    void setupLatencyTracer();
+    void addBranchLatencyPoints(int camera);
+    
+    // 카메라 브랜치 (부분 재구성 단위)
+    // 각 브랜치 앞뒤에 identity 마커를 두고, 마커 사이 구간만 새 bin으로 교체
+    enum class Branch { RECORD, INFER, ENC, ENC2, SNAPSHOT };
+    static const char* branchName(Branch branch);
+    static bool hasExitMarker(Branch branch);
+    static std::string markerName(Branch branch, int camera, bool entry);
+    static std::string marker(Branch branch, int camera, bool entry);
+    static std::string teeRefOf(const std::string& branch);
+    static std::string bodyOf(const std::string& branch, bool hasTeeRef);
+    static const std::string& branchConfig(const Config::VideoConfig& video, Branch branch);
+    static std::string& branchConfig(Config::VideoConfig& video, Branch branch);
+    static std::string snapshotSinkName(int camera) { return "snapshot_sink_" + std::to_string(camera); }
+    static std::string snapshotValveName(int camera) { return "snapshot_valve_" + std::to_string(camera); }
+    void attachSnapshotSink(int camera, GstElement* bin);
+    static std::string recordSinkName(int camera) { return "record_sink_" + std::to_string(camera); }
+    static std::string nameLastElement(const std::string& chain, const std::string& name);
+    
+    // 정지 감시: 입력은 진입 마커, 출력은 출구 마커(record는 마지막 싱크)
+    void setupWatchdog();
+    GstPad* branchOutputPad(int camera, Branch branch);
+    GstElement* branchInputQueue(int camera, Branch branch);
+    bool branchExpectsOutput(int camera, Branch branch);
+    bool branchBacklogged(int camera, Branch branch);
+    bool recoverBranch(int camera, Branch branch);
+    
+    // 공유 스케일러: 둘 이상의 브랜치가 같은 해상도를 요구하면 scale_tee에서 한 번만 스케일하고
+    // 해당 브랜치의 videorate는 프레임 분주기(fps_div)로 대체
+    using ScaleSpec = PipelineText::ScaleSpec;
+    struct ScalerPlan {
+        struct Stage {
+            int width;
+            int height;
+            std::string parent;  // 입력 tee 이름
+            bool operator==(const Stage& other) const {
+                return width == other.width && height == other.height && parent == other.parent;
+            }
+        };
+        std::vector<Stage> stages;               // 큰 해상도부터
+        std::array<std::string, 5> source;       // 브랜치별 입력 tee (비면 설정의 tee)
+        std::array<bool, 5> shared{};            // 접두부를 공유 스케일러로 대체
+        std::array<ScaleSpec, 5> spec;
+        bool operator==(const ScalerPlan& other) const {
+            return stages == other.stages && source == other.source && shared == other.shared;
+        }
+    };
+    static std::string scaleTeeName(int camera, int width, int height);
+    static std::string dividerName(int camera, Branch branch);
+    ScalerPlan planScalers(int camera, const Config::VideoConfig& video) const;
+    std::string branchSource(int camera, Branch branch, const Config::VideoConfig& video) const;
+    void installDividers(int camera, GstElement* bin);
+    static GstPadProbeReturn dividerProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    std::string branchBody(int camera, Branch branch, const Config::VideoConfig& video) const;
+    bool rebuildBranch(int camera, Branch branch, const std::string& body);
+    bool collectSegment(GstPad* entrySrc, GstElement* exit, std::vector<GstElement*>& segment);
+    void refreshElement(const std::string& name, GstElement* bin);
+    void setupGopCaches();
     bool registerElements();
+    void releaseElements();
+    bool drainSources(std::chrono::milliseconds timeout);
+    
+    ~Impl() { releaseElements(); }
+    void setupPortAllocator();
     int allocatePort();
     void releasePort(int port);
-    bool createDynamicSink(DynamicStreamInfo& info);
-    bool removeDynamicSink(const std::string& peerId);
+    bool prepareBranch(const std::shared_ptr<DynamicStreamInfo>& info);
+    bool scheduleBranchOp(const std::string& teeName, BranchOp op);
+    void armIdleProbe(const std::string& teeName);
+    void runBranchOps(const std::string& teeName);
+    bool linkBranch(DynamicStreamInfo& info, GstElement* tee);
+    void unlinkBranch(DynamicStreamInfo& info, GstElement* tee);
+    void teardownBranch(std::shared_ptr<DynamicStreamInfo> info, CompletionCallback done);
     
     // 정적 콜백
     static GstPadProbeReturn universalProbeCallback(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
-    static gboolean busCallback(GstBus* bus, GstMessage* message, gpointer userData);
+    static void busCallback(GstMessage* message, Pipeline* pipeline);
+    static GstFlowReturn onAppSinkSample(GstAppSink* appsink, gpointer userData);
+    static GstElement* branchSink(const DynamicStreamInfo& info);
+    static GstPadProbeReturn gopCacheProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    static GstPadProbeReturn egressProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    static void onQueueOverrun(GstElement* queue, gpointer userData);
+    static EgressStats snapshotEgress(const DynamicStreamInfo& info);
+    static GstPadProbeReturn branchIdleProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    static GstPadProbeReturn sourceStatsProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    static GstPadProbeReturn osdStatsProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    static GstPadProbeReturn primerGateProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData);
+    static void updateGopCache(GopCache& cache, GstBuffer* buffer, std::vector<GopReplay>& replays,
+                               bool& forceKeyUnit);
 };
 
 Pipeline::Pipeline() : impl_(std::make_unique<Impl>()) {
@@ -58,14 +492,30 @@ Pipeline::Pipeline() : impl_(std::make_unique<Impl>()) {
 
 Pipeline::~Pipeline() {
     stop();
+    // 시작하지 못한 채 해제되는 경우 (stop()이 바로 반환)
+    BusDispatcher::getInstance().detach(impl_->busOwnerId);
     LOG_TRACE("Pipeline destroyed");
 }
 
 bool Pipeline::create(const PipelineConfig& config) {
-    LOG_INFO("Creating pipeline with {} cameras", config.cameras);
-    
     impl_->config = config;
     
+    int configured = static_cast<int>(config.webrtcConfig.video.size());
+    if (impl_->config.cameras > configured) {
+        LOG_WARNING("Only {} of {} cameras have video branches configured", configured, config.cameras);
+        impl_->config.cameras = configured;
+    }
+    LOG_INFO("Creating pipeline with {} cameras", impl_->config.cameras);
+    
+    if (!impl_->teardownPool) {
+        // peer 브랜치 정리는 서로 독립적이므로 병렬 처리 (종료 시 다수 peer 동시 해제)
+        impl_->teardownPool = std::make_unique<ThreadPool>(kTeardownThreads);
+    }
+    
+    if (config.webrtcConfig.encodeOnce) {
+        LOG_INFO("Encode-once mode: recording shares the main encoder output");
+    }
+    
     // 파이프라인 문자열 생성
     std::string pipelineStr = impl_->buildPipelineString();
     LOG_DEBUG("Pipeline string length: {}", pipelineStr.length());
@@ -82,10 +532,11 @@ bool Pipeline::create(const PipelineConfig& config) {
     
     impl_->pipeline.reset(pipeline);
     
-    // 버스 설정
-    GstBus* bus = gst_element_get_bus(pipeline);
-    gst_bus_add_watch(bus, Impl::busCallback, this);
-    gst_object_unref(bus);
+    // 버스 설정 (main loop 감시 대신 공용 디스패처 스레드에서 처리, 하위 엘리먼트 상태 변경 등은 게시 시점에 필터링)
+    impl_->busOwnerId = BusDispatcher::getInstance().attach(pipeline,
+        static_cast<GstMessageType>(GST_MESSAGE_ERROR | GST_MESSAGE_WARNING | GST_MESSAGE_EOS |
+                                    GST_MESSAGE_STATE_CHANGED | GST_MESSAGE_LATENCY | GST_MESSAGE_ELEMENT),
+        [this](GstMessage* message) { Impl::busCallback(message, this); });
     
     // 엘리먼트 등록
     if (!impl_->registerElements()) {
@@ -93,26 +544,58 @@ bool Pipeline::create(const PipelineConfig& config) {
         return false;
     }
     
-    // usedPorts 초기화 - 비어있는 상태로 시작!
-    impl_->usedPorts.clear();
+    // 동적 스트림 포트 할당기 초기화 (예약 범위 제외)
+    impl_->setupPortAllocator();
+    impl_->teeSubscribers.clear();
+    
+    // 새 시청자 첫 프레임용 GOP 캐시
+    impl_->setupGopCaches();
+    
+    // snapshot 브랜치 appsink -> 메모리 캐시
+    impl_->snapshots = std::make_unique<SnapshotCache>(impl_->config.cameras,
+        std::chrono::milliseconds(config.webrtcConfig.snapshotTtlMs));
+    impl_->captureReports.assign(impl_->config.cameras, CaptureReport{});
+    for (int i = 0; i < impl_->config.cameras; ++i) {
+        impl_->setupCapture(i);
+        impl_->attachSnapshotSink(i, impl_->pipeline.get());
+        impl_->installDividers(i, impl_->pipeline.get());
+        if (config.webrtcConfig.cachedClockOverlay) {
+            impl_->installTimestampOverlay(i);
+        }
+    }
     
-    // 예약된 포트만 사용 중으로 표시
-    // 녹화용 포트
-    impl_->usedPorts.insert(7000);
-    impl_->usedPorts.insert(7001);
+    // 분석 ON/OFF 제어 (우회 경로가 없는 카메라는 빈 상태로 유지)
+    impl_->analysis.clear();
+    for (int i = 0; i < impl_->config.cameras; ++i) {
+        impl_->analysis.push_back(std::make_unique<Impl::AnalysisControl>());
+        if (impl_->bypassesAnalysis(i)) {
+            impl_->setupAnalysisControl(i);
+        }
+    }
     
-    // 정적 스트림 포트 (필요한 경우)
-    for (int i = 0; i < config.cameras; ++i) {
-        impl_->usedPorts.insert(config.basePort + i * 2);      // 메인 스트림
-        impl_->usedPorts.insert(config.basePort + i * 2 + 1);  // 서브 스트림
+    // 프레임레이트 상한 프로브 (상한이 없으면 모든 버퍼 통과)
+    impl_->rates.clear();
+    for (int i = 0; i < impl_->config.cameras; ++i) {
+        impl_->rates.push_back(std::make_unique<Impl::RateControl>());
+        impl_->setupRateControl(i);
     }
     
-    // OSD 프로브 설정
-    if (!impl_->setupOsdProbes()) {
-        LOG_ERROR("Failed to setup OSD probes");
+    // 카메라별 통계 프로브 설정
+    if (!impl_->setupStatsProbes()) {
+        LOG_ERROR("Failed to setup statistics probes");
         return false;
     }
     
+    // 캡처 -> 각 지점 지연 추적 (설정 시)
+    if (config.webrtcConfig.latencyTracing) {
+        impl_->setupLatencyTracer();
+    }
+    
+    // 브랜치 정지 감시 (설정 시, 감시 스레드는 start()에서 시작)
+    if (config.webrtcConfig.stallTimeoutMs > 0) {
+        impl_->setupWatchdog();
+    }
+    
     LOG_INFO("Pipeline created successfully");
     return true;
 }
@@ -147,452 +630,2789 @@ int Pipeline::Impl::get_udp_port(ProcessType process, CameraDevice device, Strea
     return port;
 }
 
+// 녹화 포트: record 브랜치에 지정된 udpsink 포트를 그대로 사용 (없으면 7000+i)
+int Pipeline::Impl::recordPort(int cameraIndex) const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    const auto& videos = config.webrtcConfig.video;
+    if (cameraIndex < 0 || cameraIndex >= static_cast<int>(videos.size())) {
+        return 7000 + cameraIndex;
+    }
+    return PipelineProfile::recordPort(videos[cameraIndex], cameraIndex);
+}
+
+// 설정상 항상 예약되는 포트인지 (예약 범위, 정적 스트림 포트, 다른 카메라의 녹화 포트)
+bool Pipeline::Impl::isPinnedPort(int port, int exceptCamera) const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    const auto& webrtcConfig = config.webrtcConfig;
+    
+    for (const auto& [first, last] : webrtcConfig.reservedPortRanges) {
+        if (port >= first && port <= last) return true;
+    }
+    
+    for (int i = 0; i < config.cameras; ++i) {
+        if (port == config.basePort + i * 2 || port == config.basePort + i * 2 + 1) return true;
+        if (i != exceptCamera && i < static_cast<int>(webrtcConfig.video.size()) &&
+            port == PipelineProfile::recordPort(webrtcConfig.video[i], i)) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+// encode once 모드의 메인 인코더는 녹화가 사용하므로 항상 동작
+bool Pipeline::Impl::gatesEncoder(int cameraIndex, StreamType type) const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    const auto& webrtcConfig = config.webrtcConfig;
+    if (!webrtcConfig.lazyEncoderActivation) {
+        return false;
+    }
+    if (type == StreamType::MAIN) {
+        // 메인 인코더 입력은 추론 브랜치 출력 (valve 앞단 필요)
+        return !webrtcConfig.encodeOnce && !webrtcConfig.video[cameraIndex].infer.empty();
+    }
+    return true;
+}
+
+// 체인의 첫 엘리먼트에 name 속성 추가 (이미 이름이 있으면 그대로 둠)
+std::string Pipeline::Impl::nameFirstElement(const std::string& chain, const std::string& name) {
+    size_t end = chain.find('!');
+    std::string head = chain.substr(0, end);
+    if (head.find("name=") != std::string::npos) {
+        return chain;
+    }
+    
+    size_t last = head.find_last_not_of(' ');
+    std::string named = head.substr(0, last + 1) + " name=" + name + " ";
+    return end == std::string::npos ? named : named + chain.substr(end);
+}
+
+// 체인에서 factory 엘리먼트에 name 속성 추가 (없거나 이미 이름이 있으면 그대로 둠)
+std::string Pipeline::Impl::nameElement(const std::string& chain, const std::string& factory, const std::string& name) {
+    const std::regex element("(^|!)\\s*" + factory + "(?=\\s|!|$)");
+    std::smatch match;
+    if (!std::regex_search(chain, match, element)) {
+        return chain;
+    }
+    
+    size_t begin = match.position(0) + match.length(0);
+    size_t end = chain.find('!', begin);
+    std::string props = chain.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+    if (props.find("name=") != std::string::npos) {
+        return chain;
+    }
+    return chain.substr(0, begin) + " name=" + name + chain.substr(begin);
+}
+
+// src의 clockoverlay 이름 (설정에 이름이 있으면 그 이름 사용)
+std::string Pipeline::Impl::clockOverlayName(const std::string& src, int camera) {
+    static const std::regex named(R"(clockoverlay\b[^!]*\bname=([^\s!]+))");
+    std::smatch match;
+    if (std::regex_search(src, match, named)) {
+        return match[1].str();
+    }
+    return "clock_overlay_" + std::to_string(camera);
+}
+
+// clockoverlay를 초당 한 번 렌더링 + 캐시 합성으로 전환 (src 변경은 재시작이므로 생성 시에만)
+void Pipeline::Impl::installTimestampOverlay(int camera) {
+    const std::string& src = config.webrtcConfig.video[camera].src;
+    GstElement* overlay = gst_bin_get_by_name(GST_BIN(pipeline.get()), clockOverlayName(src, camera).c_str());
+    if (!overlay) return;
+    
+    TimestampOverlay::install(overlay, camera);
+    gst_object_unref(overlay);
+}
+
+// 캡처 엘리먼트 io-mode 적용 및 버퍼 풀 크기 지정, 첫 버퍼에서 실제 협상 결과 보고
+void Pipeline::Impl::setupCapture(int camera) {
+    static const std::set<std::string> ioModes = { "auto", "rw", "mmap", "userptr", "dmabuf", "dmabuf-import" };
+    const auto& video = config.webrtcConfig.video[camera];
+    
+    GstElement* capture = gst_bin_get_by_name(GST_BIN(pipeline.get()), captureSourceName(camera).c_str());
+    if (!capture) {
+        LOG_WARNING("No capture element for camera {}, capture report unavailable", camera);
+        return;
+    }
+    
+    GstElementFactory* factory = gst_element_get_factory(capture);
+    std::string element = factory ? gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory)) : "";
+    std::string ioMode;
+    
+    if (!video.ioMode.empty()) {
+        if (element != "v4l2src") {
+            LOG_WARNING("Camera {} capture element '{}' has no io-mode, ignoring '{}'", camera, element, video.ioMode);
+        } else if (!ioModes.count(video.ioMode)) {
+            LOG_WARNING("Camera {} unknown io-mode '{}', using element default", camera, video.ioMode);
+        } else {
+            gst_util_set_object_arg(G_OBJECT(capture), "io-mode", video.ioMode.c_str());
+            ioMode = video.ioMode;
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(captureMutex);
+        captureReports[camera].element = element;
+        captureReports[camera].ioMode = ioMode;
+    }
+    
+    // 할당 쿼리(풀 크기)는 재협상 때마다, 버퍼 프로브는 첫 버퍼에서 제거
+    GstPad* pad = gst_element_get_static_pad(capture, "src");
+    if (pad) {
+        auto deleteContext = [](gpointer data) { delete static_cast<CaptureProbeContext*>(data); };
+        unsigned poolMin = static_cast<unsigned>(std::max(video.poolMinBuffers, 0));
+        unsigned poolMax = static_cast<unsigned>(std::max(video.poolMaxBuffers, 0));
+        gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM, captureProbe,
+                          new CaptureProbeContext{this, camera, poolMin, poolMax}, deleteContext);
+        gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, captureProbe,
+                          new CaptureProbeContext{this, camera, poolMin, poolMax}, deleteContext);
+        gst_object_unref(pad);
+    }
+    gst_object_unref(capture);
+}
+
+GstPadProbeReturn Pipeline::Impl::captureProbe(GstPad* /*pad*/, GstPadProbeInfo* info, gpointer userData) {
+    auto* context = static_cast<CaptureProbeContext*>(userData);
+    Impl* self = context->impl;
+    
+    if (info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+        GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+        GstMemory* memory = gst_buffer_n_memory(buffer) > 0 ? gst_buffer_peek_memory(buffer, 0) : nullptr;
+        std::string kind = !memory ? "none"
+                         : gst_memory_is_type(memory, "dmabuf") ? "dmabuf"
+                         : gst_memory_is_type(memory, "V4l2Memory") ? "mmap" : "system";
+        
+        CaptureReport report;
+        {
+            std::lock_guard<std::mutex> lock(self->captureMutex);
+            auto& stored = self->captureReports[context->camera];
+            stored.memory = kind;
+            stored.negotiated = true;
+            if (stored.bufferSize == 0) stored.bufferSize = gst_buffer_get_size(buffer);
+            report = stored;
+        }
+        
+        LOG_INFO("Camera {} capture negotiated: {} io-mode={} memory={} pool={}..{} buffers of {} bytes",
+                 context->camera, report.element, report.ioMode.empty() ? "default" : report.ioMode,
+                 report.memory, report.poolMin, report.poolMax, report.bufferSize);
+        if (report.ioMode.rfind("dmabuf", 0) == 0 && report.memory != "dmabuf") {
+            LOG_WARNING("Camera {} requested {} but buffers arrive in {} memory", context->camera,
+                        report.ioMode, report.memory);
+        }
+        return GST_PAD_PROBE_REMOVE;
+    }
+    
+    // 하류 응답 이후(PULL) 풀 크기를 설정값으로 조정 (하류 최소 요구량 이하로는 줄이지 않음)
+    GstQuery* query = GST_PAD_PROBE_INFO_QUERY(info);
+    if (GST_QUERY_TYPE(query) != GST_QUERY_ALLOCATION || !(info->type & GST_PAD_PROBE_TYPE_PULL)) {
+        return GST_PAD_PROBE_OK;
+    }
+    
+    GstBufferPool* pool = nullptr;
+    guint size = 0, min = 0, max = 0;
+    bool hasPool = gst_query_get_n_allocation_pools(query) > 0;
+    if (hasPool) {
+        gst_query_parse_nth_allocation_pool(query, 0, &pool, &size, &min, &max);
+    } else {
+        GstCaps* caps = nullptr;
+        GstVideoInfo videoInfo;
+        gst_query_parse_allocation(query, &caps, nullptr);
+        if (caps && gst_video_info_from_caps(&videoInfo, caps)) {
+            size = GST_VIDEO_INFO_SIZE(&videoInfo);
+        }
+    }
+    
+    if (context->poolMin > 0) min = std::max(min, context->poolMin);
+    if (context->poolMax > 0) max = std::max(context->poolMax, min);
+    
+    if (context->poolMin > 0 || context->poolMax > 0) {
+        if (hasPool) {
+            gst_query_set_nth_allocation_pool(query, 0, pool, size, min, max);
+        } else {
+            gst_query_add_allocation_pool(query, nullptr, size, min, max);
+        }
+    }
+    if (pool) gst_object_unref(pool);
+    
+    std::lock_guard<std::mutex> lock(self->captureMutex);
+    auto& stored = self->captureReports[context->camera];
+    stored.poolMin = min;
+    stored.poolMax = max;
+    stored.bufferSize = size;
+    return GST_PAD_PROBE_OK;
+}
+
 std::string Pipeline::Impl::buildPipelineString() {
     const auto& webrtcConfig = config.webrtcConfig;
     std::stringstream ss;
     
     // 각 비디오 소스에 대한 파이프라인 구성
-    for (int i = 0; i < webrtcConfig.deviceCnt && i < 2; ++i) {
+    for (int i = 0; i < config.cameras; ++i) {
         const auto& video = webrtcConfig.video[i];
         
-        // 1. 비디오 소스
-        ss << video.src << " ";
+        // 1. 비디오 소스 (캡처 엘리먼트와 캐시 오버레이 시 clockoverlay에 이름 부여)
+        std::string src = nameFirstElement(video.src, captureSourceName(i));
+        if (webrtcConfig.cachedClockOverlay) {
+            src = nameElement(src, "clockoverlay", clockOverlayName(src, i));
+        }
+        ss << src << " ";
+        
+        // 공유 스케일 단계 (해상도별 tee, 같은 비율의 더 큰 출력에서 이어서 축소)
+        for (const auto& stage : planScalers(i, video).stages) {
+            ss << stage.parent << ". ! queue ! videoscale ! video/x-raw,width=" << stage.width
+               << ",height=" << stage.height << " ! tee name=" << scaleTeeName(i, stage.width, stage.height)
+               << " allow-not-linked=true ";
+        }
         
-        // 2. 녹화 브랜치
-        ss << video.record << " ";
+        // 2. 녹화 브랜치 (encode once 모드에서는 메인 인코더 tee에서 분기)
+        if (!webrtcConfig.encodeOnce && !video.record.empty()) {
+            ss << teeRefOf(video.record) << " ! " << marker(Branch::RECORD, i, true) << " ! "
+               << branchBody(i, Branch::RECORD, video) << " ";
+        }
         
         // 3. 추론 브랜치가 있는 경우
+        // 분석 우회: valve는 재구성 구간 밖, 출구 마커 뒤 input-selector에서 우회 경로와 합류
         if (!video.infer.empty()) {
-            ss << video.infer << " ";
+            ss << branchSource(i, Branch::INFER, video) << " ! ";
+            if (bypassesAnalysis(i)) {
+                ss << "valve name=" << inferValveName(i) << " drop=false ! ";
+            }
+            ss << marker(Branch::INFER, i, true) << " ! "
+               << branchBody(i, Branch::INFER, video) << " ! " << marker(Branch::INFER, i, false) << " ! ";
+            if (bypassesAnalysis(i)) {
+                ss << "input-selector name=" << inferSelectorName(i) << " sync-streams=false ! ";
+            }
         }
         
         // 4. 메인 인코더 (space 추가 중요!)
-        ss << video.enc << " ";  
+        // 추론 출력과 인코더를 별도 스트리밍 스레드로 분리 (카메라별 OSD/인코더가 한 스레드를 공유하지 않도록)
+        if (!video.infer.empty() && video.enc.compare(0, 5, "queue") != 0) {
+            ss << "queue max-size-buffers=3 leaky=downstream ! ";
+        }
+        
+        // 지연 활성화: 시청자가 생길 때까지 valve로 인코더 입력 차단
+        if (gatesEncoder(i, StreamType::MAIN)) {
+            ss << "valve name=enc_valve_main_" << i << " drop=true ! ";
+        }
+        ss << marker(Branch::ENC, i, true) << " ! " << branchBody(i, Branch::ENC, video)
+           << " ! " << marker(Branch::ENC, i, false) << " ! ";
         
         // 동적 스트림을 위한 tee 추가
         ss << "tee name=stream_tee_main_" << i << " allow-not-linked=true ";
-        ss << "stream_tee_main_" << i << ". ! queue ! fakesink ";
+        ss << "stream_tee_main_" << i << ". ! queue ! fakesink async=false ";
+        
+        if (webrtcConfig.encodeOnce) {
+            // 녹화는 라이브와 동일한 H.264 RTP 스트림을 기존 녹화 포트로 수신
+            ss << "stream_tee_main_" << i << ". ! queue ! udpsink host=127.0.0.1 port="
+               << recordPort(i) << " sync=false async=false ";
+        }
+        
+        // 분석 우회 경로: 평소에는 valve로 막고, 분석을 끄면 원본 프레임을 추론 출력 caps로 변환해 전달
+        if (bypassesAnalysis(i)) {
+            ss << teeRefOf(video.infer) << " ! valve name=" << inferBypassName(i) << " drop=true ! "
+               << "queue max-size-buffers=3 leaky=downstream ! videoconvert ! videoscale ! "
+               << "capsfilter name=" << inferBypassCapsName(i) << " ! " << inferSelectorName(i) << ". ";
+        }
         
-        // 5. 서브 인코더
-        ss << video.enc2 << " ";
+        // 5. 서브 인코더 (valve는 재구성 구간 밖에 둠)
+        ss << branchSource(i, Branch::ENC2, video) << " ! ";
+        if (gatesEncoder(i, StreamType::SECONDARY)) {
+            ss << "valve name=enc_valve_sub_" << i << " drop=true ! ";
+        }
+        ss << marker(Branch::ENC2, i, true) << " ! " << branchBody(i, Branch::ENC2, video)
+           << " ! " << marker(Branch::ENC2, i, false) << " ! ";
         
         // 동적 스트림을 위한 tee 추가
         ss << "tee name=stream_tee_sub_" << i << " allow-not-linked=true ";
-        ss << "stream_tee_sub_" << i << ". ! queue ! fakesink ";
+        ss << "stream_tee_sub_" << i << ". ! queue ! fakesink async=false ";
         
         // 6. 스냅샷 브랜치
-        ss << video.snapshot << " ";
-        ss << "location=" << webrtcConfig.snapshotPath << "/cam" << i << "_snapshot.jpg ";
+        ss << branchSource(i, Branch::SNAPSHOT, video) << " ! " << marker(Branch::SNAPSHOT, i, true) << " ! "
+           << branchBody(i, Branch::SNAPSHOT, video) << " ";
     }
     
     return ss.str();
 }
 
-// 동적 스트림 추가 - 개선된 구현
-std::optional<int> Pipeline::addDynamicStream(const std::string& peerId, 
-                                             CameraDevice device, 
-                                             StreamType type) {
-    std::lock_guard<std::mutex> lock(impl_->streamMutex);
+const char* Pipeline::Impl::branchName(Branch branch) {
+    switch (branch) {
+        case Branch::RECORD: return "record";
+        case Branch::INFER: return "infer";
+        case Branch::ENC: return "enc";
+        case Branch::ENC2: return "enc2";
+        case Branch::SNAPSHOT: return "snapshot";
+    }
+    return "unknown";
+}
+
+// 싱크로 끝나는 브랜치(record, snapshot)는 출구 마커 없음
+bool Pipeline::Impl::hasExitMarker(Branch branch) {
+    return branch == Branch::INFER || branch == Branch::ENC || branch == Branch::ENC2;
+}
+
+std::string Pipeline::Impl::markerName(Branch branch, int camera, bool entry) {
+    return std::string(branchName(branch)) + (entry ? "_in_" : "_out_") + std::to_string(camera);
+}
+
+std::string Pipeline::Impl::marker(Branch branch, int camera, bool entry) {
+    return "identity name=" + markerName(branch, camera, entry) + " silent=true";
+}
+
+// "video_src_teeN. ! queue ! ..." -> "video_src_teeN."
+std::string Pipeline::Impl::teeRefOf(const std::string& branch) {
+    std::string ref = branch.substr(0, branch.find('!'));
+    size_t first = ref.find_first_not_of(' ');
+    size_t last = ref.find_last_not_of(' ');
+    return first == std::string::npos ? "" : ref.substr(first, last - first + 1);
+}
+
+// tee 참조와 끝의 링크("! ")를 제외한 브랜치 본문
+std::string Pipeline::Impl::bodyOf(const std::string& branch, bool hasTeeRef) {
+    std::string body = branch;
+    if (hasTeeRef) {
+        size_t pos = body.find('!');
+        body = pos == std::string::npos ? "" : body.substr(pos + 1);
+    }
     
-    LOG_DEBUG("Adding dynamic stream for peer: {} (device: {}, type: {})", 
-              peerId, static_cast<int>(device), static_cast<int>(type));
+    size_t last = body.find_last_not_of(' ');
+    if (last != std::string::npos && body[last] == '!') {
+        body.erase(last);
+    }
     
-    // 이미 존재하는지 확인
-    if (impl_->dynamicStreams.find(peerId) != impl_->dynamicStreams.end()) {
-        LOG_WARNING("Stream already exists for peer: {}", peerId);
-        return std::nullopt;
+    size_t first = body.find_first_not_of(' ');
+    last = body.find_last_not_of(' ');
+    return first == std::string::npos ? "" : body.substr(first, last - first + 1);
+}
+
+const std::string& Pipeline::Impl::branchConfig(const Config::VideoConfig& video, Branch branch) {
+    switch (branch) {
+        case Branch::RECORD: return video.record;
+        case Branch::INFER: return video.infer;
+        case Branch::ENC: return video.enc;
+        case Branch::ENC2: return video.enc2;
+        case Branch::SNAPSHOT: return video.snapshot;
+    }
+    return video.src;
+}
+
+std::string& Pipeline::Impl::branchConfig(Config::VideoConfig& video, Branch branch) {
+    return const_cast<std::string&>(branchConfig(static_cast<const Config::VideoConfig&>(video), branch));
+}
+
+std::string Pipeline::Impl::branchBody(int camera, Branch branch, const Config::VideoConfig& video) const {
+    std::string body = bodyOf(branchConfig(video, branch), branch != Branch::ENC);
+    
+    // 공유 스케일러 소비 브랜치: 스케일 접두부 제거, 프레임레이트 지정 시 분주기 추가
+    // (on_demand 스냅샷은 valve가 프레임을 골라내므로 분주기 불필요)
+    const ScalerPlan plan = planScalers(camera, video);
+    const int index = static_cast<int>(branch);
+    if (plan.shared[index]) {
+        const ScaleSpec& spec = plan.spec[index];
+        bool gatedSnapshot = branch == Branch::SNAPSHOT && config.webrtcConfig.snapshotMode == "on_demand";
+        std::string divider = spec.fpsNum > 0 && !gatedSnapshot
+            ? "identity name=" + dividerName(camera, branch) + " silent=true ! " : "";
+        body = "queue ! " + divider + body.substr(spec.prefixEnd);
     }
     
-    // 포트 할당
-    int port = impl_->allocatePort();
-    if (port < 0) {
-        LOG_ERROR("No available ports for dynamic stream");
-        return std::nullopt;
+    if (branch == Branch::SNAPSHOT) {
+        // 파일 싱크는 메모리 캐시용 appsink로 대체 (SD 카드 쓰기 없음)
+        // on_demand: 인코더 앞단까지만 두고 valve로 평소에는 프레임을 막음 (JPEG 인코딩은 요청 시)
+        //            valve가 프레임을 골라내므로 videorate/framerate 제한은 제거 (남겨 두면 videorate가
+        //            이전 요청의 프레임을 내보내고 막혀 있던 구간을 중복 프레임으로 채움)
+        size_t sinkPos = body.rfind("multifilesink");
+        size_t encPos = body.rfind("jpegenc");
+        bool onDemand = config.webrtcConfig.snapshotMode == "on_demand" && encPos != std::string::npos;
+        std::string appsink = "appsink name=" + snapshotSinkName(camera) +
+                              " sync=false async=false max-buffers=1 drop=true";
+        
+        if (onDemand) {
+            std::string convert = PipelineText::stripRateControl(body.substr(0, encPos));
+            body = "valve name=" + snapshotValveName(camera) + " drop=true ! " +
+                   (convert.empty() ? "" : convert + " ! ") + appsink;
+        } else if (sinkPos != std::string::npos) {
+            body = body.substr(0, sinkPos) + appsink;
+        } else {
+            body += " location=" + config.webrtcConfig.snapshotPath + "/cam" + std::to_string(camera) + "_snapshot.jpg";
+        }
     }
     
-    // 스트림 정보 생성
-    DynamicStreamInfo info;
-    info.peerId = peerId;
-    info.device = device;
-    info.type = type;
-    info.port = port;
-    info.active = false;
+    // 정지 감시의 출력 지점 (record는 출구 마커 없이 싱크로 끝남)
+    if (branch == Branch::RECORD) {
+        body = nameLastElement(body, recordSinkName(camera));
+    }
+    return body;
+}
+
+// 본문 앞의 "queue ! [videorate !] videoscale ! video/x-raw,width=W,height=H[,framerate=N/D] !" 해석
+// width/height/framerate 외의 caps 필드가 있거나 스케일이 없으면 공유 대상 아님
+std::string Pipeline::Impl::scaleTeeName(int camera, int width, int height) {
+    return "scale_tee_" + std::to_string(camera) + "_" + std::to_string(width) + "x" + std::to_string(height);
+}
+
+std::string Pipeline::Impl::dividerName(int camera, Branch branch) {
+    return std::string("fps_div_") + branchName(branch) + "_" + std::to_string(camera);
+}
+
+Pipeline::Impl::ScalerPlan Pipeline::Impl::planScalers(int camera, const Config::VideoConfig& video) const {
+    ScalerPlan plan;
+    if (!config.webrtcConfig.sharedScaler) {
+        return plan;
+    }
     
-    // 동적 싱크 생성 (타임아웃 적용)
-    auto createFuture = std::async(std::launch::async, [this, &info]() {
-        return impl_->createDynamicSink(info);
-    });
+    const std::string sourceTee = "video_src_tee" + std::to_string(camera);
+    std::map<std::pair<int, int>, int> consumers;
     
-    auto status = createFuture.wait_for(std::chrono::seconds(3));
-    if (status != std::future_status::ready) {
-        impl_->releasePort(port);
-        LOG_ERROR("Dynamic sink creation timed out for peer: {}", peerId);
-        return std::nullopt;
+    for (Branch branch : {Branch::INFER, Branch::ENC2, Branch::SNAPSHOT}) {
+        const std::string& branchText = branchConfig(video, branch);
+        if (branchText.empty() || teeRefOf(branchText) != sourceTee + ".") continue;
+        
+        auto spec = PipelineText::parseScalePrefix(bodyOf(branchText, true));
+        if (!spec) continue;
+        
+        plan.spec[static_cast<int>(branch)] = *spec;
+        ++consumers[{spec->width, spec->height}];
     }
     
-    if (!createFuture.get()) {
-        impl_->releasePort(port);
-        LOG_ERROR("Failed to create dynamic sink for peer: {}", peerId);
-        return std::nullopt;
+    // 같은 해상도 소비자가 둘 이상일 때만 스케일 단계 생성 (단일 소비자는 자체 valve 뒤에서 스케일)
+    for (const auto& [size, count] : consumers) {
+        if (count >= 2) plan.stages.push_back({size.first, size.second, sourceTee});
     }
+    std::sort(plan.stages.begin(), plan.stages.end(), [](const auto& a, const auto& b) {
+        return a.width * a.height > b.width * b.height;
+    });
     
-    // 스트림 정보 저장
-    impl_->dynamicStreams[peerId] = info;
+    // 가로세로 비율이 같고 크거나 같은 단계의 출력을 입력으로 사용 (축소만)
+    auto findParent = [&plan](int width, int height, size_t limit) -> const ScalerPlan::Stage* {
+        for (size_t k = 0; k < limit; ++k) {
+            const auto& stage = plan.stages[k];
+            if (stage.width >= width && stage.height >= height &&
+                stage.width * height == width * stage.height &&
+                (stage.width != width || stage.height != height)) {
+                return &stage;
+            }
+        }
+        return nullptr;
+    };
+    for (size_t k = 0; k < plan.stages.size(); ++k) {
+        if (auto* parent = findParent(plan.stages[k].width, plan.stages[k].height, k)) {
+            plan.stages[k].parent = scaleTeeName(camera, parent->width, parent->height);
+        }
+    }
     
-    LOG_INFO("✅ Added dynamic stream for peer {} on port {} (device: {}, type: {})", 
-             peerId, port, static_cast<int>(device), static_cast<int>(type));
+    for (Branch branch : {Branch::INFER, Branch::ENC2, Branch::SNAPSHOT}) {
+        const int index = static_cast<int>(branch);
+        const ScaleSpec& spec = plan.spec[index];
+        if (spec.width == 0) continue;
+        
+        if (consumers[{spec.width, spec.height}] >= 2) {
+            plan.shared[index] = true;
+            plan.source[index] = scaleTeeName(camera, spec.width, spec.height) + ".";
+        } else if (auto* parent = findParent(spec.width, spec.height, plan.stages.size())) {
+            plan.source[index] = scaleTeeName(camera, parent->width, parent->height) + ".";
+        }
+    }
     
-    return port;
+    return plan;
 }
 
-// 동적 싱크 생성
-bool Pipeline::Impl::createDynamicSink(DynamicStreamInfo& info) {
-    if (!pipeline) return false;
-    
-    LOG_DEBUG("Creating dynamic sink for peer: {}, device: {}, type: {}, port: {}", 
-              info.peerId, static_cast<int>(info.device), 
-              static_cast<int>(info.type), info.port);
-    
-    // Tee 엘리먼트 찾기
-    std::string teeName = "stream_tee_";
-    teeName += (info.type == StreamType::MAIN) ? "main_" : "sub_";
-    teeName += std::to_string(static_cast<int>(info.device));
+std::string Pipeline::Impl::branchSource(int camera, Branch branch, const Config::VideoConfig& video) const {
+    std::string source = planScalers(camera, video).source[static_cast<int>(branch)];
+    return source.empty() ? teeRefOf(branchConfig(video, branch)) : source;
+}
+
+// 분주기 프로브 설치 (파이프라인 생성 및 브랜치 재구성 후)
+void Pipeline::Impl::installDividers(int camera, GstElement* bin) {
+    const ScalerPlan plan = planScalers(camera, config.webrtcConfig.video[camera]);
     
-    GstElement* tee = gst_bin_get_by_name(GST_BIN(pipeline.get()), teeName.c_str());
-    if (!tee) {
-        LOG_ERROR("Tee element not found: {}", teeName);
-        return false;
+    for (Branch branch : {Branch::INFER, Branch::ENC2, Branch::SNAPSHOT}) {
+        const ScaleSpec& spec = plan.spec[static_cast<int>(branch)];
+        if (!plan.shared[static_cast<int>(branch)] || spec.fpsNum <= 0) continue;
+        
+        GstElement* divider = gst_bin_get_by_name(GST_BIN(bin), dividerName(camera, branch).c_str());
+        if (!divider) continue;
+        
+        if (GstPad* pad = gst_element_get_static_pad(divider, "src")) {
+            gst_pad_add_probe(pad,
+                static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM),
+                dividerProbe, new FrameDivider{spec.fpsNum, spec.fpsDen},
+                [](gpointer data) { delete static_cast<FrameDivider*>(data); });
+            gst_object_unref(pad);
+            LOG_DEBUG("Frame divider {} -> {}/{} fps", dividerName(camera, branch), spec.fpsNum, spec.fpsDen);
+        }
+        gst_object_unref(divider);
+    }
+}
+
+// 입력 프레임레이트가 목표보다 높으면 목표 주기마다 한 프레임만 통과 (rate_governor 상한으로 입력이 줄어도 누적 분주 없음)
+// caps의 framerate도 목표 값으로 바꿔 인코더 비트레이트 계산이 맞도록 함
+GstPadProbeReturn Pipeline::Impl::dividerProbe(GstPad*, GstPadProbeInfo* info, gpointer userData) {
+    auto* divider = static_cast<FrameDivider*>(userData);
+    
+    if (info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+        if (divider->ratio == 1) {
+            return GST_PAD_PROBE_OK;
+        }
+        const GstClockTime period = gst_util_uint64_scale_int(GST_SECOND, divider->fpsDen, divider->fpsNum);
+        return passesFrameInterval(divider->next, period, GST_BUFFER_PTS(GST_PAD_PROBE_INFO_BUFFER(info)))
+            ? GST_PAD_PROBE_OK : GST_PAD_PROBE_DROP;
     }
     
-    // 동적 엘리먼트 생성
-    std::string queueName = "queue_" + info.peerId;
-    std::string sinkName = "udpsink_" + info.peerId;
+    GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+    if (GST_EVENT_TYPE(event) != GST_EVENT_CAPS) {
+        return GST_PAD_PROBE_OK;
+    }
     
-    info.queue = gst_element_factory_make("queue", queueName.c_str());
-    info.udpsink = gst_element_factory_make("udpsink", sinkName.c_str());
+    GstCaps* caps = nullptr;
+    gst_event_parse_caps(event, &caps);
+    gint num = 0, den = 1;
+    if (!caps || !gst_structure_get_fraction(gst_caps_get_structure(caps, 0), "framerate", &num, &den) ||
+        num <= 0 || den <= 0) {
+        return GST_PAD_PROBE_OK;  // 가변 프레임레이트: 그대로 통과
+    }
     
-    if (!info.queue || !info.udpsink) {
-        LOG_ERROR("Failed to create elements for dynamic stream");
-        if (info.queue) gst_object_unref(info.queue);
-        if (info.udpsink) gst_object_unref(info.udpsink);
-        gst_object_unref(tee);
-        return false;
+    double ratio = (static_cast<double>(num) / den) / (static_cast<double>(divider->fpsNum) / divider->fpsDen);
+    divider->ratio = std::max<uint64_t>(1, static_cast<uint64_t>(ratio + 0.5));
+    divider->next = GST_CLOCK_TIME_NONE;
+    if (divider->ratio == 1) {
+        return GST_PAD_PROBE_OK;
     }
     
-    // Queue 설정
-    g_object_set(info.queue,
-                 "max-size-buffers", 10,
-                 "max-size-time", G_GUINT64_CONSTANT(0),
-                 "max-size-bytes", 0,
-                 "leaky", 2,  // downstream
-                 nullptr);
+    GstCaps* divided = gst_caps_copy(caps);
+    gst_caps_set_simple(divided, "framerate", GST_TYPE_FRACTION, divider->fpsNum, divider->fpsDen, nullptr);
+    GST_PAD_PROBE_INFO_DATA(info) = gst_event_new_caps(divided);
+    gst_caps_unref(divided);
+    gst_event_unref(event);
     
-    // UDP sink 설정
-    g_object_set(info.udpsink,
-                 "host", "127.0.0.1",
-                 "port", info.port,
-                 "sync", FALSE,
-                 "async", FALSE,
-                 nullptr);
+    return GST_PAD_PROBE_OK;
+}
+
+// 카메라 브랜치 부분 재구성
+// 바뀐 브랜치만 마커 사이 구간을 새 bin으로 교체하고 나머지 브랜치/peer는 계속 송출
+Pipeline::ReconfigureResult Pipeline::reconfigure(const Config::WebRTCConfig& webrtcConfig) {
+    ReconfigureResult result;
     
-    LOG_INFO("Created UDP sink for peer {} on port {} (device: {}, type: {})", 
-             info.peerId, info.port, 
-             static_cast<int>(info.device), 
-             static_cast<int>(info.type));
+    if (!impl_->pipeline) {
+        result.restartRequired = true;
+        return result;
+    }
     
-    // 파이프라인에 추가
-    gst_bin_add_many(GST_BIN(pipeline.get()), info.queue, info.udpsink, nullptr);
+    std::lock_guard<std::mutex> branchLock(impl_->branchMutex);
+    auto& current = impl_->config.webrtcConfig;
+    const int cameras = impl_->config.cameras;
     
-    // 링크
-    if (!gst_element_link(info.queue, info.udpsink)) {
-        LOG_ERROR("Failed to link queue to udpsink");
-        gst_bin_remove_many(GST_BIN(pipeline.get()), info.queue, info.udpsink, nullptr);
-        gst_object_unref(tee);
-        return false;
+    if (static_cast<int>(webrtcConfig.video.size()) != cameras) {
+        LOG_WARNING("Camera count changed ({} -> {}), restart required", cameras, webrtcConfig.video.size());
+        result.restartRequired = true;
     }
     
-    // Tee에서 새 패드 요청
-    GstPad* teeSrcPad = gst_element_get_request_pad(tee, "src_%u");
-    GstPad* queueSinkPad = gst_element_get_static_pad(info.queue, "sink");
+    if (webrtcConfig.snapshotMode != current.snapshotMode) {
+        LOG_WARNING("Snapshot mode changed, restart required");
+        result.restartRequired = true;
+    }
     
-    // 패드 연결
-    if (gst_pad_link(teeSrcPad, queueSinkPad) != GST_PAD_LINK_OK) {
-        LOG_ERROR("Failed to link tee to queue");
-        gst_element_release_request_pad(tee, teeSrcPad);
-        gst_object_unref(teeSrcPad);
-        gst_object_unref(queueSinkPad);
-        gst_bin_remove_many(GST_BIN(pipeline.get()), info.queue, info.udpsink, nullptr);
-        gst_object_unref(tee);
+    if (webrtcConfig.cachedClockOverlay != current.cachedClockOverlay) {
+        LOG_WARNING("Clock overlay mode changed, restart required");
+        result.restartRequired = true;
+    }
+    
+    if (webrtcConfig.analysisBypass != current.analysisBypass) {
+        LOG_WARNING("Analysis bypass setting changed, restart required");
+        result.restartRequired = true;
+    }
+    
+    if (webrtcConfig.stallTimeoutMs != current.stallTimeoutMs ||
+        webrtcConfig.stallRecoveryAttempts != current.stallRecoveryAttempts) {
+        LOG_WARNING("Stall watchdog settings changed, restart required");
+        result.restartRequired = true;
+    }
+    
+    using Branch = Impl::Branch;
+    const Branch branches[] = { Branch::RECORD, Branch::INFER, Branch::ENC, Branch::ENC2, Branch::SNAPSHOT };
+    
+    for (int i = 0; i < cameras && i < static_cast<int>(webrtcConfig.video.size()); ++i) {
+        auto& video = current.video[i];
+        const auto& next = webrtcConfig.video[i];
+        {
+            std::lock_guard<std::mutex> lock(impl_->stateMutex);
+            video.label = next.label;
+        }
+        
+        // 소스가 바뀌면 카메라 전체 브랜치가 영향을 받으므로 재시작 필요
+        if (video.src != next.src) {
+            LOG_WARNING("Camera {} source changed, restart required", i);
+            result.restartRequired = true;
+            continue;
+        }
+        
+        if (video.ioMode != next.ioMode || video.poolMinBuffers != next.poolMinBuffers ||
+            video.poolMaxBuffers != next.poolMaxBuffers) {
+            LOG_WARNING("Camera {} capture settings changed, restart required", i);
+            result.restartRequired = true;
+            continue;
+        }
+        
+        // 공유 스케일 단계나 브랜치 입력 tee가 바뀌는 변경도 구조 변경
+        if (!(impl_->planScalers(i, video) == impl_->planScalers(i, next))) {
+            LOG_WARNING("Camera {} scaler layout changed, restart required", i);
+            result.restartRequired = true;
+            continue;
+        }
+        
+        for (Branch branch : branches) {
+            const std::string& before = Impl::branchConfig(video, branch);
+            const std::string& after = Impl::branchConfig(next, branch);
+            if (before == after) continue;
+            
+            std::string name = "cam" + std::to_string(i) + "." + Impl::branchName(branch);
+            
+            // encode once 모드의 record 설정은 녹화 포트 조회에만 사용
+            if (branch == Branch::RECORD && current.encodeOnce) {
+                std::lock_guard<std::mutex> lock(impl_->stateMutex);
+                Impl::branchConfig(video, branch) = after;
+                continue;
+            }
+            
+            // 브랜치 추가/삭제나 분기 tee 변경은 구조 변경이므로 재시작 필요
+            if (before.empty() || after.empty() ||
+                (branch != Branch::ENC && Impl::teeRefOf(before) != Impl::teeRefOf(after))) {
+                LOG_WARNING("Branch {} topology changed, restart required", name);
+                result.restartRequired = true;
+                continue;
+            }
+            
+            // 녹화 포트 변경: 새 udpsink가 뜨기 전에 예약 (예약 후 확인해야 peer 할당과 경합하지 않음)
+            int oldPort = -1;
+            int newPort = -1;
+            if (branch == Branch::RECORD && impl_->ports) {
+                oldPort = impl_->recordPort(i);
+                newPort = PipelineProfile::recordPort(next, i);
+                if (newPort != oldPort) {
+                    impl_->ports->reserve(newPort, newPort);
+                    if (impl_->ports->isAllocated(newPort)) {
+                        LOG_ERROR("Branch {} record port {} is in use by a peer stream", name, newPort);
+                        impl_->ports->unreserve(newPort, newPort);
+                        result.failed.push_back({i, Impl::branchName(branch)});
+                        continue;
+                    }
+                }
+            }
+            
+            // 재구성 중 참조하는 설정(분주기 목표 등)은 새 값 기준, 실패 시 되돌림
+            std::string previous = before;
+            {
+                std::lock_guard<std::mutex> lock(impl_->stateMutex);
+                Impl::branchConfig(video, branch) = after;
+            }
+            
+            bool rebuilt = impl_->rebuildBranch(i, branch, impl_->branchBody(i, branch, next));
+            if (rebuilt) {
+                result.rebuilt.push_back({i, Impl::branchName(branch)});
+            } else {
+                std::lock_guard<std::mutex> lock(impl_->stateMutex);
+                Impl::branchConfig(video, branch) = previous;
+                result.failed.push_back({i, Impl::branchName(branch)});
+            }
+            
+            // 교체 성공 시 이전 포트, 실패 시 새 포트 예약을 되돌림 (다른 용도로 고정된 포트는 유지)
+            if (newPort != oldPort) {
+                int stale = rebuilt ? oldPort : newPort;
+                if (!impl_->isPinnedPort(stale, i)) {
+                    impl_->ports->unreserve(stale, stale);
+                }
+            }
+        }
+    }
+    
+    LOG_INFO("Pipeline reconfigured: {} branches rebuilt, {} failed{}", result.rebuilt.size(),
+             result.failed.size(), result.restartRequired ? ", restart required for remaining changes" : "");
+    return result;
+}
+
+// 마커 하류 구간 교체 (설정 스레드에서 호출, 교체 완료까지 대기)
+bool Pipeline::Impl::rebuildBranch(int camera, Branch branch, const std::string& body) {
+    GstBin* bin = GST_BIN(pipeline.get());
+    std::string entryName = markerName(branch, camera, true);
+    std::string binName = std::string(branchName(branch)) + "_bin_" + std::to_string(camera);
+    
+    GstPtr<GstElement> entry(gst_bin_get_by_name(bin, entryName.c_str()));
+    GstPtr<GstElement> exit;
+    if (hasExitMarker(branch)) {
+        exit.reset(gst_bin_get_by_name(bin, markerName(branch, camera, false).c_str()));
+    }
+    if (!entry || (hasExitMarker(branch) && !exit)) {
+        LOG_ERROR("Branch markers not found for {}", binName);
         return false;
     }
     
-    // 디버깅: UDP sink로 가는 데이터 확인
-    GstPad* sinkPad = gst_element_get_static_pad(info.udpsink, "sink");
-    if (sinkPad) {
-        gst_pad_add_probe(sinkPad, GST_PAD_PROBE_TYPE_BUFFER,
-            [](GstPad* pad, GstPadProbeInfo* info, gpointer userData) -> GstPadProbeReturn {
-                static int count = 0;
-                if (++count % 30 == 0) {  // 30 프레임마다
-                    auto* streamInfo = static_cast<DynamicStreamInfo*>(userData);
-                    GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
-                    LOG_DEBUG("✅ UDP sink sending data to port {}: buffer size = {}", 
-                             streamInfo->port, gst_buffer_get_size(buffer));
+    // 새 구간을 먼저 생성 (설정 오류 시 기존 브랜치 유지)
+    GError* error = nullptr;
+    GstElement* replacement = gst_parse_bin_from_description(body.c_str(), TRUE, &error);
+    if (error || !replacement) {
+        LOG_ERROR("Failed to build {}: {}", binName, error ? error->message : "unknown error");
+        if (error) g_error_free(error);
+        if (replacement) gst_object_unref(replacement);
+        return false;
+    }
+    gst_object_ref_sink(replacement);
+    
+    struct SwapJob {
+        Impl* impl;
+        GstPad* entrySrc = nullptr;
+        GstElement* exit = nullptr;
+        GstElement* replacement = nullptr;
+        std::vector<GstElement*> segment;
+        std::string binName;
+        gulong dropId = 0;
+        std::atomic<bool> claimed{false};  // IDLE 프로브(교체 시작)와 시간 초과(취소) 중 먼저 잡은 쪽이 진행
+        std::promise<bool> done;
+        
+        ~SwapJob() {
+            for (GstElement* element : segment) gst_object_unref(element);
+            if (replacement) gst_object_unref(replacement);
+            if (exit) gst_object_unref(exit);
+            if (entrySrc) gst_object_unref(entrySrc);
+        }
+    };
+    
+    auto job = std::make_shared<SwapJob>();
+    job->impl = this;
+    job->entrySrc = gst_element_get_static_pad(entry.get(), "src");
+    job->exit = exit.release();
+    job->replacement = replacement;
+    job->binName = binName;
+    auto done = job->done.get_future();
+    
+    if (!collectSegment(job->entrySrc, job->exit, job->segment)) {
+        LOG_ERROR("Failed to resolve current elements of {}", binName);
+        return false;
+    }
+    
+    // 교체 중 입력 버퍼는 버림 (하류 미연결 상태의 NOT_LINKED가 상류 스레드를 멈추지 않도록)
+    job->dropId = gst_pad_add_probe(job->entrySrc,
+        static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST),
+        [](GstPad*, GstPadProbeInfo*, gpointer) -> GstPadProbeReturn { return GST_PAD_PROBE_DROP; },
+        nullptr, nullptr);
+    
+    // 데이터가 흐르지 않는 시점에 분리하고, 상태 변경/교체는 정리 스레드에서 수행
+    gst_pad_add_probe(job->entrySrc, GST_PAD_PROBE_TYPE_IDLE,
+        [](GstPad* pad, GstPadProbeInfo*, gpointer userData) -> GstPadProbeReturn {
+            auto job = *static_cast<std::shared_ptr<SwapJob>*>(userData);
+            if (job->claimed.exchange(true)) {
+                return GST_PAD_PROBE_REMOVE;  // 시간 초과로 취소됨 (기존 구간 유지)
+            }
+            
+            if (GstPad* peer = gst_pad_get_peer(pad)) {
+                gst_pad_unlink(pad, peer);
+                gst_object_unref(peer);
+            }
+            
+            job->impl->teardownPool->enqueue([job]() {
+                GstBin* pipelineBin = GST_BIN(job->impl->pipeline.get());
+                
+                for (GstElement* element : job->segment) {
+                    gst_element_set_state(element, GST_STATE_NULL);
+                }
+                for (GstElement* element : job->segment) {
+                    gst_bin_remove(pipelineBin, element);
+                }
+                
+                g_object_set(job->replacement, "name", job->binName.c_str(), nullptr);
+                gst_bin_add(pipelineBin, job->replacement);
+                
+                bool linked = false;
+                if (GstPad* binSink = gst_element_get_static_pad(job->replacement, "sink")) {
+                    linked = gst_pad_link(job->entrySrc, binSink) == GST_PAD_LINK_OK;
+                    gst_object_unref(binSink);
+                }
+                if (linked && job->exit) {
+                    linked = gst_element_link(job->replacement, job->exit);
+                }
+                
+                gst_element_sync_state_with_parent(job->replacement);
+                gst_pad_remove_probe(job->entrySrc, job->dropId);
+                
+                if (!linked) {
+                    LOG_ERROR("Failed to link rebuilt {}", job->binName);
+                }
+                job->done.set_value(linked);
+            });
+            
+            return GST_PAD_PROBE_REMOVE;
+        },
+        new std::shared_ptr<SwapJob>(job),
+        [](gpointer data) { delete static_cast<std::shared_ptr<SwapJob>*>(data); });
+    
+    if (done.wait_for(std::chrono::seconds(5)) != std::future_status::ready) {
+        if (!job->claimed.exchange(true)) {
+            // 교체 시작 전: 입력 차단만 풀고 기존 구간 유지 (남은 IDLE 프로브는 실행 시 스스로 제거)
+            gst_pad_remove_probe(job->entrySrc, job->dropId);
+            LOG_ERROR("Timed out rebuilding {}, keeping previous branch", binName);
+            return false;
+        }
+        // 이미 분리가 시작되었으면 교체 완료까지 대기 (실패 보고 후 뒤늦게 교체되지 않도록)
+        LOG_WARNING("Rebuilding {} is taking longer than expected, waiting for swap to finish", binName);
+    }
+    if (!done.get()) {
+        return false;
+    }
+    
+    // 재구성 구간의 엘리먼트를 참조하던 등록 정보/프로브 갱신
+    if (branch == Branch::INFER) {
+        refreshElement("nvosd_" + std::to_string(camera + 1), job->replacement);
+        attachOsdStatsProbe(camera);
+        applyInferenceInterval(camera);
+    }
+    if (branch == Branch::ENC || branch == Branch::ENC2) {
+        attachEncoderLimiter(camera, branch == Branch::ENC ? StreamType::MAIN : StreamType::SECONDARY);
+    }
+    if (branch == Branch::SNAPSHOT) {
+        attachSnapshotSink(camera, job->replacement);
+    }
+    if (branch == Branch::RECORD && watchdog && watchIds[camera][static_cast<int>(branch)] >= 0) {
+        GstPad* output = branchOutputPad(camera, branch);
+        watchdog->attachOutput(watchIds[camera][static_cast<int>(branch)], output);
+        if (output) gst_object_unref(output);
+    }
+    installDividers(camera, job->replacement);
+    if (latencyTracer && branch != Branch::RECORD && branch != Branch::SNAPSHOT) {
+        addBranchLatencyPoints(camera);
+    }
+    
+    LOG_INFO("Rebuilt {} without stopping the pipeline", binName);
+    return true;
+}
+
+// 진입 마커 하류에서 출구 마커(또는 싱크)까지의 엘리먼트 수집 (참조 보유)
+bool Pipeline::Impl::collectSegment(GstPad* entrySrc, GstElement* exit, std::vector<GstElement*>& segment) {
+    std::vector<GstPad*> frontier;
+    if (GstPad* peer = gst_pad_get_peer(entrySrc)) {
+        frontier.push_back(peer);
+    }
+    
+    bool reachedExit = (exit == nullptr);
+    bool valid = true;
+    
+    while (!frontier.empty()) {
+        GstPad* pad = frontier.back();
+        frontier.pop_back();
+        GstElement* element = gst_pad_get_parent_element(pad);
+        gst_object_unref(pad);
+        if (!element) continue;
+        
+        if (element == exit) {
+            reachedExit = true;
+            gst_object_unref(element);
+            continue;
+        }
+        if (std::find(segment.begin(), segment.end(), element) != segment.end()) {
+            gst_object_unref(element);
+            continue;
+        }
+        
+        // 공유 엘리먼트까지 내려가면 마커 구성이 잘못된 것
+        std::string name = GST_OBJECT_NAME(element);
+        if (name.rfind("stream_tee_", 0) == 0 || name.rfind("video_src_tee", 0) == 0 ||
+            name.rfind("scale_tee_", 0) == 0 ||
+            name.rfind("enc_valve_", 0) == 0) {
+            LOG_ERROR("Branch segment reaches shared element {}", name);
+            gst_object_unref(element);
+            valid = false;
+            break;
+        }
+        
+        segment.push_back(element);
+        gst_element_foreach_src_pad(element,
+            [](GstElement*, GstPad* srcPad, gpointer userData) -> gboolean {
+                if (GstPad* peer = gst_pad_get_peer(srcPad)) {
+                    static_cast<std::vector<GstPad*>*>(userData)->push_back(peer);
                 }
-                return GST_PAD_PROBE_OK;
+                return TRUE;
             },
-            &info,
-            nullptr);
+            &frontier);
+    }
+    
+    for (GstPad* pad : frontier) gst_object_unref(pad);
+    
+    if (!valid || !reachedExit || segment.empty()) {
+        for (GstElement* element : segment) gst_object_unref(element);
+        segment.clear();
+        return false;
+    }
+    return true;
+}
+
+// snapshot appsink를 캐시에 연결 (파일 싱크를 쓰는 사용자 정의 브랜치는 그대로 둠)
+void Pipeline::Impl::attachSnapshotSink(int camera, GstElement* bin) {
+    GstElement* sink = gst_bin_get_by_name(GST_BIN(bin), snapshotSinkName(camera).c_str());
+    if (!sink) return;
+    
+    GstElement* valve = gst_bin_get_by_name(GST_BIN(bin), snapshotValveName(camera).c_str());
+    snapshots->attach(sink, camera, valve);
+    if (valve) gst_object_unref(valve);
+    gst_object_unref(sink);
+}
+
+// 체인의 마지막 엘리먼트에 name 속성 추가 (이미 이름이 있으면 그대로 둠)
+std::string Pipeline::Impl::nameLastElement(const std::string& chain, const std::string& name) {
+    size_t link = chain.rfind('!');
+    std::string tail = chain.substr(link == std::string::npos ? 0 : link + 1);
+    if (tail.find("name=") != std::string::npos) {
+        return chain;
+    }
+    
+    size_t last = chain.find_last_not_of(' ');
+    return chain.substr(0, last == std::string::npos ? 0 : last + 1) + " name=" + name;
+}
+
+// 감시 대상: 출력이 계속 나와야 하는 브랜치 (snapshot은 on_demand/저속이라 제외)
+void Pipeline::Impl::setupWatchdog() {
+    const auto& webrtcConfig = config.webrtcConfig;
+    watchdog = std::make_unique<BranchWatchdog>(std::chrono::milliseconds(webrtcConfig.stallTimeoutMs),
+                                                webrtcConfig.stallRecoveryAttempts);
+    watchIds.assign(config.cameras, {-1, -1, -1, -1, -1});
+    
+    const Branch watched[] = { Branch::RECORD, Branch::INFER, Branch::ENC, Branch::ENC2 };
+    for (int i = 0; i < config.cameras; ++i) {
+        const auto& video = webrtcConfig.video[i];
+        for (Branch branch : watched) {
+            if (branchConfig(video, branch).empty() || (branch == Branch::RECORD && webrtcConfig.encodeOnce)) {
+                continue;
+            }
+            
+            std::string name = "cam" + std::to_string(i) + "." + branchName(branch);
+            GstElement* entry = gst_bin_get_by_name(GST_BIN(pipeline.get()), markerName(branch, i, true).c_str());
+            GstPad* input = entry ? gst_element_get_static_pad(entry, "src") : nullptr;
+            GstPad* output = branchOutputPad(i, branch);
+            
+            if (input && output) {
+                int id = watchdog->addTarget({name, i, static_cast<int>(branch)});
+                watchdog->attachInput(id, input);
+                watchdog->attachOutput(id, output);
+                watchIds[i][static_cast<int>(branch)] = id;
+            } else {
+                LOG_WARNING("No watch points for {}, stall watchdog disabled for it", name);
+            }
+            
+            if (input) gst_object_unref(input);
+            if (output) gst_object_unref(output);
+            if (entry) gst_object_unref(entry);
+        }
+    }
+}
+
+GstPad* Pipeline::Impl::branchOutputPad(int camera, Branch branch) {
+    bool exitMarker = hasExitMarker(branch);
+    std::string name = exitMarker ? markerName(branch, camera, false) : recordSinkName(camera);
+    
+    GstElement* element = gst_bin_get_by_name(GST_BIN(pipeline.get()), name.c_str());
+    if (!element) return nullptr;
+    
+    GstPad* pad = gst_element_get_static_pad(element, exitMarker ? "src" : "sink");
+    gst_object_unref(element);
+    return pad;
+}
+
+// 진입 마커 바로 뒤의 queue (재구성된 bin이면 고스트 패드 안쪽)
+GstElement* Pipeline::Impl::branchInputQueue(int camera, Branch branch) {
+    GstElement* entry = gst_bin_get_by_name(GST_BIN(pipeline.get()), markerName(branch, camera, true).c_str());
+    if (!entry) return nullptr;
+    
+    GstPad* src = gst_element_get_static_pad(entry, "src");
+    gst_object_unref(entry);
+    GstPad* peer = src ? gst_pad_get_peer(src) : nullptr;
+    if (src) gst_object_unref(src);
+    
+    while (peer && GST_IS_GHOST_PAD(peer)) {
+        GstPad* target = gst_ghost_pad_get_target(GST_GHOST_PAD(peer));
+        gst_object_unref(peer);
+        peer = target;
+    }
+    if (!peer) return nullptr;
+    
+    GstElement* element = gst_pad_get_parent_element(peer);
+    gst_object_unref(peer);
+    if (!element) return nullptr;
+    
+    GstElementFactory* factory = gst_element_get_factory(element);
+    if (!factory || std::strcmp(gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory)), "queue") != 0) {
+        gst_object_unref(element);
+        return nullptr;
+    }
+    return element;
+}
+
+// 지연 활성화로 valve가 닫힌 인코더, 분석이 꺼진 추론 브랜치는 출력이 없는 것이 정상
+bool Pipeline::Impl::branchExpectsOutput(int camera, Branch branch) {
+    if (!running) return false;
+    if (branch == Branch::INFER) return analysis[camera]->enabled;  // 분석을 끄면 추론 입력이 없음
+    if (branch != Branch::ENC && branch != Branch::ENC2) return true;
+    
+    StreamType type = branch == Branch::ENC ? StreamType::MAIN : StreamType::SECONDARY;
+    if (!gatesEncoder(camera, type)) return true;
+    
+    std::string valveName = std::string(type == StreamType::MAIN ? "enc_valve_main_" : "enc_valve_sub_") +
+                            std::to_string(camera);
+    GstElement* valve = gst_bin_get_by_name(GST_BIN(pipeline.get()), valveName.c_str());
+    if (!valve) return true;
+    
+    gboolean drop = FALSE;
+    g_object_get(valve, "drop", &drop, nullptr);
+    gst_object_unref(valve);
+    return !drop;
+}
+
+// 입력 queue가 한도까지 차 있으면 하류가 소비하지 않아 진입 마커(및 공유 tee)를 막고 있는 상태
+bool Pipeline::Impl::branchBacklogged(int camera, Branch branch) {
+    GstElement* queue = branchInputQueue(camera, branch);
+    if (!queue) return false;
+    
+    guint buffers = 0, maxBuffers = 0, bytes = 0, maxBytes = 0;
+    guint64 time = 0, maxTime = 0;
+    g_object_get(queue, "current-level-buffers", &buffers, "max-size-buffers", &maxBuffers,
+                 "current-level-bytes", &bytes, "max-size-bytes", &maxBytes,
+                 "current-level-time", &time, "max-size-time", &maxTime, nullptr);
+    gst_object_unref(queue);
+    
+    return (maxBuffers > 0 && buffers >= maxBuffers) || (maxBytes > 0 && bytes >= maxBytes) ||
+           (maxTime > 0 && time >= maxTime);
+}
+
+// 정지한 브랜치를 같은 설정으로 다시 구성 (감시 스레드)
+bool Pipeline::Impl::recoverBranch(int camera, Branch branch) {
+    std::lock_guard<std::mutex> lock(branchMutex);
+    if (!running) return false;
+    
+    // 가득 찬 입력 queue에서 진입 마커 스레드가 대기 중이면 IDLE 프로브가 실행되지 않으므로
+    // leaky로 바꾸고 용량을 다시 설정해 대기 중인 push를 깨움 (queue는 교체 대상이라 복원 불필요)
+    if (GstElement* queue = branchInputQueue(camera, branch)) {
+        guint maxBuffers = 0;
+        g_object_get(queue, "max-size-buffers", &maxBuffers, nullptr);
+        g_object_set(queue, "leaky", 2, "max-size-buffers", maxBuffers, nullptr);
+        gst_object_unref(queue);
+    }
+    
+    return rebuildBranch(camera, branch, branchBody(camera, branch, config.webrtcConfig.video[camera]));
+}
+
+SnapshotCache* Pipeline::getSnapshotCache() const {
+    return impl_->snapshots.get();
+}
+
+// 이름 등록 정보를 재구성된 bin 내부 엘리먼트로 교체
+void Pipeline::Impl::refreshElement(const std::string& name, GstElement* bin) {
+    GstElement* element = gst_bin_get_by_name(GST_BIN(bin), name.c_str());
+    
+    std::lock_guard<std::mutex> lock(stateMutex);
+    auto it = elements.find(name);
+    if (it != elements.end()) {
+        gst_object_unref(it->second);
+        elements.erase(it);
+    }
+    if (element) {
+        elements[name] = element;
+    }
+}
+
+// 동적 스트림 추가
+// 브랜치 엘리먼트는 즉시 생성하고, tee 연결은 tee의 IDLE 프로브에서 스트리밍 스레드가 일괄 처리
+std::optional<int> Pipeline::addDynamicStream(const std::string& peerId, 
+                                             CameraDevice device, 
+                                             StreamType type,
+                                             CompletionCallback onComplete) {
+    std::string teeName;
+    bool armProbe = false;
+    int port = -1;
+    
+    {
+        std::lock_guard<std::mutex> lock(impl_->streamMutex);
+        
+        LOG_DEBUG("Adding dynamic stream for peer: {} (device: {}, type: {})", 
+                  peerId, static_cast<int>(device), static_cast<int>(type));
+        
+        // 이미 존재하는지 확인
+        if (impl_->dynamicStreams.find(peerId) != impl_->dynamicStreams.end()) {
+            LOG_WARNING("Stream already exists for peer: {}", peerId);
+            return std::nullopt;
+        }
+        
+        // 포트 할당
+        port = impl_->allocatePort();
+        if (port < 0) {
+            LOG_ERROR("No available ports for dynamic stream");
+            return std::nullopt;
+        }
+        
+        // 스트림 정보 생성
+        auto info = std::make_shared<DynamicStreamInfo>();
+        info->peerId = peerId;
+        info->device = device;
+        info->type = type;
+        info->port = port;
+        info->active = false;
+        
+        // 공유 파이프라인 모드: peer bin이 준비되면 attachPeerBin()에서 브랜치 생성
+        if (impl_->config.transport == StreamTransport::SHARED_PIPELINE) {
+            impl_->dynamicStreams[peerId] = info;
+            LOG_INFO("Reserved shared stream slot for peer {} (device: {}, type: {})", 
+                     peerId, static_cast<int>(device), static_cast<int>(type));
+            return port;
+        }
+        
+        if (!impl_->prepareBranch(info)) {
+            impl_->releasePort(port);
+            LOG_ERROR("Failed to create dynamic sink for peer: {}", peerId);
+            return std::nullopt;
+        }
+        
+        impl_->dynamicStreams[peerId] = info;
+        impl_->acquireEncoder(*info);
+        
+        teeName = Impl::streamTeeName(*info);
+        armProbe = impl_->scheduleBranchOp(teeName, {Impl::BranchOp::ATTACH, info, std::move(onComplete)});
+    }
+    
+    // IDLE 프로브는 즉시 실행될 수 있으므로 streamMutex 해제 후 설치
+    if (armProbe) {
+        impl_->armIdleProbe(teeName);
+    }
+    
+    LOG_INFO("✅ Added dynamic stream for peer {} on port {} (device: {}, type: {})", 
+             peerId, port, static_cast<int>(device), static_cast<int>(type));
+    
+    return port;
+}
+
+// 브랜치 엘리먼트 생성 (queue -> sink), tee 연결은 linkBranch()에서 수행
+bool Pipeline::Impl::prepareBranch(const std::shared_ptr<DynamicStreamInfo>& infoPtr) {
+    if (!pipeline) return false;
+    
+    DynamicStreamInfo& info = *infoPtr;
+    
+    LOG_DEBUG("Creating dynamic sink for peer: {}, device: {}, type: {}, port: {}", 
+              info.peerId, static_cast<int>(info.device), 
+              static_cast<int>(info.type), info.port);
+    
+    // Tee 엘리먼트 확인
+    std::string teeName = streamTeeName(info);
+    if (teeElements.find(teeName) == teeElements.end()) {
+        LOG_ERROR("Tee element not found: {}", teeName);
+        return false;
+    }
+    
+    // 동적 엘리먼트 생성
+    std::string queueName = "queue_" + info.peerId;
+    info.queue = gst_element_factory_make("queue", queueName.c_str());
+    
+    if (config.transport == StreamTransport::SHARED_PIPELINE) {
+        // peer bin은 WebRTCPeer가 생성/소유
+    } else if (config.transport == StreamTransport::APPSINK) {
+        std::string sinkName = "appsink_" + info.peerId;
+        info.appsink = gst_element_factory_make("appsink", sinkName.c_str());
+    } else {
+        std::string sinkName = "udpsink_" + info.peerId;
+        info.udpsink = gst_element_factory_make("udpsink", sinkName.c_str());
+    }
+    GstElement* sink = branchSink(info);
+    
+    if (!info.queue || !sink) {
+        LOG_ERROR("Failed to create elements for dynamic stream");
+        if (info.queue) gst_object_unref(info.queue);
+        if (info.udpsink) gst_object_unref(info.udpsink);
+        if (info.appsink) gst_object_unref(info.appsink);
+        info.queue = nullptr;
+        info.udpsink = nullptr;
+        info.appsink = nullptr;
+        return false;
+    }
+    
+    // Queue 설정
+    g_object_set(info.queue,
+                 "max-size-buffers", 10,
+                 "max-size-time", G_GUINT64_CONSTANT(0),
+                 "max-size-bytes", 0,
+                 "leaky", 2,  // downstream
+                 nullptr);
+    
+    if (info.peerBin) {
+        LOG_INFO("Attaching WebRTC bin for peer {} to shared pipeline (device: {}, type: {})", 
+                 info.peerId, 
+                 static_cast<int>(info.device), 
+                 static_cast<int>(info.type));
+    } else if (info.appsink) {
+        // App sink 설정 - peer의 appsrc가 연결될 때까지는 최신 버퍼만 유지
+        GstCaps* caps = gst_caps_from_string(
+            "application/x-rtp,media=video,clock-rate=90000,encoding-name=H264,payload=96");
+        g_object_set(info.appsink,
+                     "caps", caps,
+                     "emit-signals", FALSE,
+                     "max-buffers", 1,
+                     "drop", TRUE,
+                     "sync", FALSE,
+                     "async", FALSE,
+                     "buffer-list", config.webrtcConfig.egressBufferLists ? TRUE : FALSE,
+                     nullptr);
+        gst_caps_unref(caps);
+        
+        LOG_INFO("Created app sink for peer {} (device: {}, type: {})", 
+                 info.peerId, 
+                 static_cast<int>(info.device), 
+                 static_cast<int>(info.type));
+    } else {
+        // UDP sink 설정
+        g_object_set(info.udpsink,
+                     "host", "127.0.0.1",
+                     "port", info.port,
+                     "sync", FALSE,
+                     "async", FALSE,
+                     nullptr);
+        
+        LOG_INFO("Created UDP sink for peer {} on port {} (device: {}, type: {})", 
+                 info.peerId, info.port, 
+                 static_cast<int>(info.device), 
+                 static_cast<int>(info.type));
+    }
+    
+    // 파이프라인에 추가
+    gst_bin_add_many(GST_BIN(pipeline.get()), info.queue, sink, nullptr);
+    
+    // 링크
+    if (!gst_element_link(info.queue, sink)) {
+        LOG_ERROR("Failed to link queue to sink");
+        gst_bin_remove_many(GST_BIN(pipeline.get()), info.queue, sink, nullptr);
+        info.queue = nullptr;
+        info.udpsink = nullptr;
+        info.appsink = nullptr;
+        return false;
+    }
+    
+    // 송출 통계: sink 입력 바이트/버퍼 수, leaky queue 오버런(드롭) 횟수
+    info.metrics = std::make_shared<StreamMetrics>();
+    
+    GstPad* sinkPad = gst_element_get_static_pad(sink, "sink");
+    if (sinkPad) {
+        gst_pad_add_probe(sinkPad,
+            static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST),
+            Impl::egressProbe,
+            new std::shared_ptr<StreamMetrics>(info.metrics),
+            [](gpointer data) { delete static_cast<std::shared_ptr<StreamMetrics>*>(data); });
+        if (latencyTracer) {
+            latencyTracer->addMeasurePoint(sinkPad, static_cast<int>(info.device), latencyPointName(info));
+        }
         gst_object_unref(sinkPad);
     }
     
-    info.teepad = teeSrcPad;
-    gst_object_unref(queueSinkPad);
-    gst_object_unref(tee);
+    g_signal_connect_data(info.queue, "overrun", G_CALLBACK(Impl::onQueueOverrun),
+        new std::shared_ptr<StreamMetrics>(info.metrics),
+        [](gpointer data, GClosure*) { delete static_cast<std::shared_ptr<StreamMetrics>*>(data); },
+        G_CONNECT_DEFAULT);
+    
+    // 첫 키프레임(또는 GOP 캐시) 전달 전까지 디코딩 불가한 델타 프레임 차단
+    if (gopCaches.find(teeName) != gopCaches.end()) {
+        info.primer = std::make_shared<StreamPrimer>();
+        info.primer->peerId = info.peerId;
+        info.primer->attachedAtUs = steadyNowUs();
+    }
     
-    // 엘리먼트 동기화 및 재생
+    // 엘리먼트 동기화 및 재생 (tee 연결 전이므로 데이터 없이 대기)
     gst_element_sync_state_with_parent(info.queue);
-    gst_element_sync_state_with_parent(info.udpsink);
+    gst_element_sync_state_with_parent(sink);
+    
+    return true;
+}
+
+// 동적 스트림 제거
+// tee 분리는 IDLE 프로브에서, 엘리먼트 정리는 teardown 스레드에서 비동기로 수행
+bool Pipeline::removeDynamicStream(const std::string& peerId, CompletionCallback onComplete) {
+    std::string teeName;
+    bool armProbe = false;
+    bool reservedOnly = false;
+    
+    {
+        std::lock_guard<std::mutex> lock(impl_->streamMutex);
+        
+        auto it = impl_->dynamicStreams.find(peerId);
+        if (it == impl_->dynamicStreams.end()) {
+            LOG_WARNING("Stream not found for peer: {}", peerId);
+            return false;
+        }
+        
+        std::shared_ptr<DynamicStreamInfo> info = it->second;
+        impl_->dynamicStreams.erase(it);
+        
+        if (!info->queue) {
+            // 브랜치 없이 예약만 된 공유 모드 슬롯
+            impl_->releasePort(info->port);
+            reservedOnly = true;
+        } else {
+            impl_->releaseEncoder(*info);
+            teeName = Impl::streamTeeName(*info);
+            armProbe = impl_->scheduleBranchOp(teeName, {Impl::BranchOp::DETACH, info, std::move(onComplete)});
+        }
+    }
     
-    info.active = true;
+    if (armProbe) {
+        impl_->armIdleProbe(teeName);
+    }
     
-    LOG_INFO("✅ Dynamic sink created successfully for peer {} on port {}", 
-             info.peerId, info.port);
+    if (reservedOnly && onComplete) {
+        onComplete(true);
+    }
     
+    LOG_INFO("Removed dynamic stream for peer: {}", peerId);
     return true;
 }
 
-// 동적 스트림 제거
-bool Pipeline::removeDynamicStream(const std::string& peerId) {
-    std::lock_guard<std::mutex> lock(impl_->streamMutex);
+// tee별 대기 작업 추가, IDLE 프로브 설치가 필요하면 true 반환
+bool Pipeline::Impl::scheduleBranchOp(const std::string& teeName, BranchOp op) {
+    std::lock_guard<std::mutex> lock(opsMutex);
     
-    auto it = impl_->dynamicStreams.find(peerId);
-    if (it == impl_->dynamicStreams.end()) {
-        LOG_WARNING("Stream not found for peer: {}", peerId);
+    auto& queue = teeOps[teeName];
+    queue.ops.push_back(std::move(op));
+    
+    if (queue.probeArmed) {
         return false;
     }
-    
-    DynamicStreamInfo& info = it->second;
-    
-    if (!impl_->removeDynamicSink(peerId)) {
-        LOG_ERROR("Failed to remove dynamic sink for peer: {}", peerId);
+    
+    queue.probeArmed = true;
+    return true;
+}
+
+void Pipeline::Impl::armIdleProbe(const std::string& teeName) {
+    auto teeIt = teeElements.find(teeName);
+    GstPad* sinkPad = teeIt != teeElements.end() ? gst_element_get_static_pad(teeIt->second, "sink") : nullptr;
+    
+    if (!sinkPad) {
+        LOG_ERROR("Cannot schedule branch changes on {}", teeName);
+        runBranchOps(teeName);
+        return;
+    }
+    
+    // 데이터가 흐르지 않는 시점(버퍼 사이)에 스트리밍 스레드에서 실행, 이미 idle이면 즉시 실행
+    gst_pad_add_probe(sinkPad, GST_PAD_PROBE_TYPE_IDLE, Impl::branchIdleProbe,
+        new IdleProbeData{this, teeName},
+        [](gpointer data) { delete static_cast<IdleProbeData*>(data); });
+    gst_object_unref(sinkPad);
+}
+
+GstPadProbeReturn Pipeline::Impl::branchIdleProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData) {
+    (void)pad; (void)info;
+    auto* data = static_cast<IdleProbeData*>(userData);
+    data->impl->runBranchOps(data->teeName);
+    return GST_PAD_PROBE_REMOVE;
+}
+
+// 쌓인 attach/detach 작업을 한 번에 적용
+void Pipeline::Impl::runBranchOps(const std::string& teeName) {
+    std::vector<BranchOp> batch;
+    {
+        std::lock_guard<std::mutex> lock(opsMutex);
+        auto& queue = teeOps[teeName];
+        batch.swap(queue.ops);
+        queue.probeArmed = false;
+    }
+    
+    auto teeIt = teeElements.find(teeName);
+    GstElement* tee = teeIt != teeElements.end() ? teeIt->second : nullptr;
+    
+    for (auto& op : batch) {
+        if (op.kind == BranchOp::ATTACH) {
+            if (tee && linkBranch(*op.info, tee)) {
+                if (op.done) op.done(true);
+                continue;
+            }
+            
+            LOG_ERROR("Failed to attach branch for peer: {}", op.info->peerId);
+            {
+                std::lock_guard<std::mutex> lock(streamMutex);
+                auto it = dynamicStreams.find(op.info->peerId);
+                if (it != dynamicStreams.end() && it->second == op.info) {
+                    dynamicStreams.erase(it);
+                    releaseEncoder(*op.info);
+                }
+            }
+            teardownBranch(op.info, [done = std::move(op.done)](bool) {
+                if (done) done(false);
+            });
+        } else {
+            if (tee) {
+                unlinkBranch(*op.info, tee);
+            }
+            teardownBranch(op.info, std::move(op.done));
+        }
+    }
+    
+    if (batch.size() > 1) {
+        LOG_INFO("Applied {} branch changes on {} in one pass", batch.size(), teeName);
+    }
+}
+
+// 스트리밍 스레드(IDLE)에서 호출: tee 요청 패드를 브랜치 queue에 연결
+bool Pipeline::Impl::linkBranch(DynamicStreamInfo& info, GstElement* tee) {
+    GstPad* teeSrcPad = gst_element_get_request_pad(tee, "src_%u");
+    GstPad* queueSinkPad = gst_element_get_static_pad(info.queue, "sink");
+    
+    if (!teeSrcPad || !queueSinkPad) {
+        if (teeSrcPad) {
+            gst_element_release_request_pad(tee, teeSrcPad);
+            gst_object_unref(teeSrcPad);
+        }
+        if (queueSinkPad) gst_object_unref(queueSinkPad);
+        return false;
+    }
+    
+    // 첫 프레임 게이트는 링크 전에 설치
+    std::shared_ptr<GopCache> cache;
+    if (info.primer) {
+        auto cacheIt = gopCaches.find(streamTeeName(info));
+        if (cacheIt != gopCaches.end()) {
+            cache = cacheIt->second;
+            info.primer->teePad = GST_PAD(gst_object_ref(teeSrcPad));
+            
+            gst_pad_add_probe(teeSrcPad,
+                static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST),
+                Impl::primerGateProbe,
+                new std::shared_ptr<StreamPrimer>(info.primer),
+                [](gpointer data) { delete static_cast<std::shared_ptr<StreamPrimer>*>(data); });
+        }
+    }
+    
+    // 패드 연결
+    if (gst_pad_link(teeSrcPad, queueSinkPad) != GST_PAD_LINK_OK) {
+        LOG_ERROR("Failed to link tee to queue");
+        gst_element_release_request_pad(tee, teeSrcPad);
+        gst_object_unref(teeSrcPad);
+        gst_object_unref(queueSinkPad);
+        return false;
+    }
+    gst_object_unref(queueSinkPad);
+    
+    if (cache) {
+        std::lock_guard<std::mutex> cacheLock(cache->mutex);
+        cache->pending.push_back(info.primer);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        info.teepad = teeSrcPad;
+        info.active = true;
+    }
+    
+    LOG_INFO("✅ Dynamic sink linked for peer {} on port {}", info.peerId, info.port);
+    return true;
+}
+
+// 스트리밍 스레드(IDLE)에서 호출: 버퍼가 흐르지 않는 시점에 tee 요청 패드 해제
+void Pipeline::Impl::unlinkBranch(DynamicStreamInfo& info, GstElement* tee) {
+    // 첫 프레임 대기 목록에서 제거 (해제될 패드에 push하지 않도록)
+    if (info.primer) {
+        auto cacheIt = gopCaches.find(streamTeeName(info));
+        if (cacheIt != gopCaches.end()) {
+            cacheIt->second->remove(info.primer);
+        }
+    }
+    
+    GstPad* teePad = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        teePad = info.teepad;
+        info.teepad = nullptr;
+        info.active = false;
+    }
+    
+    if (!teePad) {
+        return;
+    }
+    
+    GstPad* queueSinkPad = gst_element_get_static_pad(info.queue, "sink");
+    if (queueSinkPad) {
+        gst_pad_unlink(teePad, queueSinkPad);
+        gst_object_unref(queueSinkPad);
+    }
+    
+    gst_element_release_request_pad(tee, teePad);
+    gst_object_unref(teePad);
+}
+
+// 분리된 브랜치 엘리먼트 정리 (스트리밍 스레드를 막지 않도록 별도 스레드에서 수행)
+void Pipeline::Impl::teardownBranch(std::shared_ptr<DynamicStreamInfo> info, CompletionCallback done) {
+    teardownPool->enqueue([this, info, done = std::move(done)]() {
+        GstElement* sink = branchSink(*info);
+        
+        // 같은 peerId로 재연결한 새 스트림의 지점은 남도록 이 브랜치 싱크 패드의 지점만 제거
+        if (latencyTracer && sink) {
+            if (GstPad* sinkPad = gst_element_get_static_pad(sink, "sink")) {
+                latencyTracer->removePoint(latencyPointName(*info), sinkPad);
+                gst_object_unref(sinkPad);
+            }
+        }
+        
+        // 엘리먼트 상태를 NULL로 변경
+        if (info->queue) {
+            gst_element_set_state(info->queue, GST_STATE_NULL);
+        }
+        if (sink) {
+            gst_element_set_state(sink, GST_STATE_NULL);
+        }
+        
+        // 파이프라인에서 제거 (appsink 제거 시 연결된 appsrc 참조도 함께 해제됨)
+        // peer bin은 WebRTCPeer가 별도 참조를 보유하므로 여기서는 파이프라인 참조만 해제
+        if (info->queue && sink) {
+            gst_bin_remove_many(GST_BIN(pipeline.get()), info->queue, sink, nullptr);
+        }
+        info->queue = nullptr;
+        
+        // 싱크가 더 이상 송신하지 않으므로 포트 재사용 가능
+        releasePort(info->port);
+        info->primer.reset();
+        
+        LOG_DEBUG("Dynamic branch torn down for peer: {}", info->peerId);
+        
+        if (done) done(true);
+    });
+}
+
+std::string Pipeline::Impl::streamTeeName(const DynamicStreamInfo& info) {
+    std::string teeName = "stream_tee_";
+    teeName += (info.type == StreamType::MAIN) ? "main_" : "sub_";
+    teeName += std::to_string(static_cast<int>(info.device));
+    return teeName;
+}
+
+std::string Pipeline::Impl::latencyPointName(const DynamicStreamInfo& info) {
+    std::string name = "cam" + std::to_string(static_cast<int>(info.device));
+    name += (info.type == StreamType::MAIN) ? ".main" : ".sub";
+    return name + ".peer." + info.peerId;
+}
+
+// 첫 시청자 연결 시 인코더 활성화
+void Pipeline::Impl::acquireEncoder(const DynamicStreamInfo& info) {
+    const std::string teeName = streamTeeName(info);
+    auto cacheIt = gopCaches.find(teeName);
+    if (cacheIt != gopCaches.end()) {
+        cacheIt->second->subscribers.fetch_add(1);
+    }
+    if (++teeSubscribers[teeName] == 1) {
+        setEncoderActive(info, true);
+    }
+}
+
+// 마지막 시청자 해제 시 인코더 정지
+void Pipeline::Impl::releaseEncoder(const DynamicStreamInfo& info) {
+    const std::string teeName = streamTeeName(info);
+    auto it = teeSubscribers.find(teeName);
+    if (it == teeSubscribers.end()) {
+        return;
+    }
+    
+    auto cacheIt = gopCaches.find(teeName);
+    if (cacheIt != gopCaches.end()) {
+        cacheIt->second->subscribers.fetch_sub(1);
+    }
+    if (--it->second <= 0) {
+        teeSubscribers.erase(it);
+        setEncoderActive(info, false);
+    }
+}
+
+void Pipeline::Impl::setEncoderActive(const DynamicStreamInfo& info, bool active) {
+    std::string valveName = "enc_valve_";
+    valveName += (info.type == StreamType::MAIN) ? "main_" : "sub_";
+    valveName += std::to_string(static_cast<int>(info.device));
+    
+    // 지연 활성화가 꺼져 있거나 게이트되지 않는 인코더
+    GstElement* valve = gst_bin_get_by_name(GST_BIN(pipeline.get()), valveName.c_str());
+    if (!valve) {
+        return;
+    }
+    
+    g_object_set(valve, "drop", active ? FALSE : TRUE, nullptr);
+    
+    if (active) {
+        // 재개 직후 시청자가 바로 디코딩할 수 있도록 키프레임 요청
+        GstElement* tee = gst_bin_get_by_name(GST_BIN(pipeline.get()), streamTeeName(info).c_str());
+        if (tee) {
+            gst_element_send_event(tee,
+                gst_video_event_new_upstream_force_key_unit(GST_CLOCK_TIME_NONE, TRUE, 0));
+            gst_object_unref(tee);
+        }
+    }
+    
+    LOG_INFO("Encoder {} {}", valveName, active ? "activated" : "idled");
+    gst_object_unref(valve);
+}
+
+void Pipeline::Impl::setupGopCaches() {
+    gopCaches.clear();
+    
+    for (const auto& [teeName, tee] : teeElements) {
+        GstPad* sinkPad = gst_element_get_static_pad(tee, "sink");
+        if (!sinkPad) {
+            LOG_WARNING("Failed to get sink pad for {}", teeName);
+            continue;
+        }
+        
+        auto cache = std::make_shared<GopCache>();
+        cache->teeName = teeName;
+        cache->maxAgeUs = static_cast<int64_t>(config.webrtcConfig.gopCacheMaxAgeMs) * 1000;
+        cache->replayAsList = config.webrtcConfig.egressBufferLists;
+        
+        gst_pad_add_probe(sinkPad,
+            static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST),
+            Impl::gopCacheProbe,
+            new std::shared_ptr<GopCache>(cache),
+            [](gpointer data) { delete static_cast<std::shared_ptr<GopCache>*>(data); });
+        gst_object_unref(sinkPad);
+        
+        gopCaches[teeName] = cache;
+        LOG_DEBUG("GOP cache installed on {}", teeName);
+    }
+}
+
+GstPadProbeReturn Pipeline::Impl::gopCacheProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData) {
+    auto& cache = **static_cast<std::shared_ptr<GopCache>*>(userData);
+    
+    std::vector<GopReplay> replays;
+    bool forceKeyUnit = false;
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        
+        // 시청자가 없으면 복사하지 않음 (다음 시청자는 새 키프레임부터 캐시)
+        if (cache.subscribers.load(std::memory_order_relaxed) == 0 && cache.pending.empty()) {
+            cache.clear();
+            cache.lastWasDelta = true;
+            return GST_PAD_PROBE_OK;
+        }
+        
+        if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+            GstBufferList* list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+            guint length = gst_buffer_list_length(list);
+            for (guint i = 0; i < length; ++i) {
+                updateGopCache(cache, gst_buffer_list_get(list, i), replays, forceKeyUnit);
+            }
+        } else {
+            updateGopCache(cache, GST_PAD_PROBE_INFO_BUFFER(info), replays, forceKeyUnit);
+        }
+    }
+    
+    // 잠금 밖에서 전달: 느린 peer 브랜치가 다른 시청자 연결/해제를 막지 않도록
+    // 같은 스트리밍 스레드에서 현재 버퍼보다 먼저 push되므로 순서는 유지됨
+    for (auto& replay : replays) {
+        if (cache.replayAsList) {
+            GstBufferList* list = gst_buffer_list_new_sized(replay.buffers.size());
+            for (GstBuffer* cached : replay.buffers) {
+                gst_buffer_list_add(list, cached);
+            }
+            gst_pad_push_list(replay.pad, list);
+        } else {
+            for (GstBuffer* cached : replay.buffers) {
+                gst_pad_push(replay.pad, cached);
+            }
+        }
+        gst_object_unref(replay.pad);
+    }
+    if (forceKeyUnit) {
+        gst_pad_push_event(pad, gst_video_event_new_upstream_force_key_unit(GST_CLOCK_TIME_NONE, TRUE, 0));
+    }
+    
+    return GST_PAD_PROBE_OK;
+}
+
+// tee 스트리밍 스레드에서 호출 (cache.mutex 보유): 대기 중인 브랜치를 먼저 처리한 뒤 캐시 갱신
+// 캐시 전달과 키프레임 요청은 replays/forceKeyUnit으로 모아 호출 측이 잠금 해제 후 수행
+void Pipeline::Impl::updateGopCache(GopCache& cache, GstBuffer* buffer, std::vector<GopReplay>& replays,
+                                    bool& forceKeyUnit) {
+    const int64_t now = steadyNowUs();
+    const bool keyUnit = !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+    const bool gopStart = keyUnit && cache.lastWasDelta;
+    const bool cacheFresh = !cache.buffers.empty() && now - cache.gopStartUs <= cache.maxAgeUs;
+    
+    for (auto it = cache.pending.begin(); it != cache.pending.end();) {
+        auto& primer = *it;
+        
+        int64_t startUs = primer->requestedAtUs.load();
+        if (startUs == 0 && now - primer->attachedAtUs > kPrimeFallbackUs) {
+            startUs = primer->attachedAtUs;
+        }
+        if (startUs == 0) {
+            ++it;
+            continue;
+        }
+        
+        if (gopStart) {
+            // 현재 버퍼가 새 GOP 시작: 그대로 통과시키면 됨
+            primer->primed = true;
+        } else if (cacheFresh) {
+            // 캐시된 GOP를 현재 버퍼보다 먼저 전달 (게이트 프로브는 primed 이후 통과)
+            primer->primed = true;
+            GopReplay replay{GST_PAD(gst_object_ref(primer->teePad)), {}};
+            replay.buffers.reserve(cache.buffers.size());
+            for (GstBuffer* cached : cache.buffers) {
+                replay.buffers.push_back(gst_buffer_ref(cached));
+            }
+            replays.push_back(std::move(replay));
+        } else {
+            if (!primer->keyframeRequested) {
+                forceKeyUnit = true;
+                primer->keyframeRequested = true;
+                LOG_DEBUG("GOP cache on {} stale, forced keyframe for peer {}", 
+                          cache.teeName, primer->peerId);
+            }
+            ++it;
+            continue;
+        }
+        
+        int64_t ttffUs = now - startUs;
+        PerformanceMonitor::getInstance().recordMetric("stream.time_to_first_frame", ttffUs);
+        LOG_INFO("First frame delivered to peer {} in {} ms ({})", 
+                 primer->peerId, ttffUs / 1000, gopStart ? "live keyframe" : "GOP cache");
+        
+        it = cache.pending.erase(it);
+    }
+    
+    if (gopStart) {
+        cache.clear();
+        cache.gopStartUs = now;
+    }
+    
+    if (!cache.buffers.empty() || gopStart) {
+        if (cache.buffers.size() < kMaxGopCachePackets) {
+            cache.buffers.push_back(gst_buffer_ref(buffer));
+        } else {
+            cache.clear();
+        }
+    }
+    
+    cache.lastWasDelta = !keyUnit;
+}
+
+GstPadProbeReturn Pipeline::Impl::primerGateProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData) {
+    (void)pad; (void)info;
+    auto& primer = **static_cast<std::shared_ptr<StreamPrimer>*>(userData);
+    
+    if (primer.primed.load(std::memory_order_relaxed)) {
+        return GST_PAD_PROBE_REMOVE;
+    }
+    
+    return GST_PAD_PROBE_DROP;
+}
+
+void Pipeline::Impl::setupPortAllocator() {
+    const auto& webrtcConfig = config.webrtcConfig;
+    
+    // 기본 동적 포트 범위: basePort+100 ~ basePort+999 (5100-5999)
+    int firstPort = webrtcConfig.dynamicPortStart > 0 ? webrtcConfig.dynamicPortStart : config.basePort + 100;
+    int lastPort = webrtcConfig.dynamicPortEnd > 0 ? webrtcConfig.dynamicPortEnd : config.basePort + 999;
+    
+    ports = std::make_unique<PortAllocator>(firstPort, lastPort, 2);
+    
+    for (const auto& [first, last] : webrtcConfig.reservedPortRanges) {
+        ports->reserve(first, last);
+    }
+    
+    // 녹화/정적 스트림 포트가 동적 범위와 겹치는 경우 대비
+    for (int i = 0; i < config.cameras; ++i) {
+        ports->reserve(recordPort(i), recordPort(i));
+        ports->reserve(config.basePort + i * 2, config.basePort + i * 2 + 1);
+    }
+    
+    auto occupancy = ports->getOccupancy();
+    LOG_INFO("Dynamic stream ports {}-{}: {} available, {} reserved", 
+             firstPort, lastPort, occupancy.capacity, occupancy.reserved);
+}
+
+// 포트 할당
+int Pipeline::Impl::allocatePort() {
+    if (!ports) return -1;
+    
+    int port = ports->allocate();
+    if (port < 0) {
+        auto occupancy = ports->getOccupancy();
+        LOG_ERROR("No available ports in range {}-{} ({} in use)", 
+                  ports->getFirstPort(), ports->getLastPort(), occupancy.used);
+        return -1;
+    }
+    
+    LOG_DEBUG("Allocated port: {}", port);
+    return port;
+}
+
+// 포트 해제
+void Pipeline::Impl::releasePort(int port) {
+    if (ports && ports->release(port)) {
+        LOG_DEBUG("Released port: {}", port);
+    } else {
+        LOG_WARNING("Attempted to release unused port: {}", port);
+    }
+}
+
+PortAllocator::Occupancy Pipeline::getPortOccupancy() const {
+    if (!impl_->ports) return {};
+    return impl_->ports->getOccupancy();
+}
+
+// 스트림 정보 조회
+std::optional<Pipeline::DynamicStreamInfo> 
+Pipeline::getDynamicStreamInfo(const std::string& peerId) const {
+    std::lock_guard<std::mutex> lock(impl_->streamMutex);
+    
+    auto it = impl_->dynamicStreams.find(peerId);
+    if (it != impl_->dynamicStreams.end()) {
+        DynamicStreamInfo info = *it->second;
+        info.egress = Impl::snapshotEgress(info);
+        return info;
+    }
+    
+    return std::nullopt;
+}
+
+std::unordered_map<std::string, Pipeline::EgressStats> Pipeline::getEgressStatistics() const {
+    std::lock_guard<std::mutex> lock(impl_->streamMutex);
+    
+    std::unordered_map<std::string, EgressStats> result;
+    result.reserve(impl_->dynamicStreams.size());
+    
+    for (const auto& [peerId, info] : impl_->dynamicStreams) {
+        result.emplace(peerId, Impl::snapshotEgress(*info));
+    }
+    
+    return result;
+}
+
+// streamMutex 보유 상태에서 호출 (queue가 teardown되지 않음을 보장)
+Pipeline::EgressStats Pipeline::Impl::snapshotEgress(const DynamicStreamInfo& info) {
+    EgressStats stats;
+    
+    if (info.metrics) {
+        stats.bytes = info.metrics->bytes.load(std::memory_order_relaxed);
+        stats.buffers = info.metrics->buffers.load(std::memory_order_relaxed);
+        stats.sends = info.metrics->sends.load(std::memory_order_relaxed);
+        stats.lists = info.metrics->lists.load(std::memory_order_relaxed);
+        stats.overruns = info.metrics->overruns.load(std::memory_order_relaxed);
+    }
+    
+    if (info.queue) {
+        g_object_get(info.queue,
+                     "current-level-buffers", &stats.queueLevelBuffers,
+                     "current-level-time", &stats.queueLevelTimeNs,
+                     nullptr);
+    }
+    
+    return stats;
+}
+
+GstPadProbeReturn Pipeline::Impl::egressProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData) {
+    (void)pad;
+    auto& metrics = **static_cast<std::shared_ptr<StreamMetrics>*>(userData);
+    
+    if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+        GstBufferList* list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+        metrics.bytes.fetch_add(gst_buffer_list_calculate_size(list), std::memory_order_relaxed);
+        metrics.buffers.fetch_add(gst_buffer_list_length(list), std::memory_order_relaxed);
+        metrics.lists.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        metrics.bytes.fetch_add(gst_buffer_get_size(GST_PAD_PROBE_INFO_BUFFER(info)), std::memory_order_relaxed);
+        metrics.buffers.fetch_add(1, std::memory_order_relaxed);
+    }
+    metrics.sends.fetch_add(1, std::memory_order_relaxed);
+    
+    return GST_PAD_PROBE_OK;
+}
+
+void Pipeline::Impl::onQueueOverrun(GstElement* queue, gpointer userData) {
+    (void)queue;
+    auto& metrics = **static_cast<std::shared_ptr<StreamMetrics>*>(userData);
+    metrics.overruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 활성 peer ID 목록
+std::vector<std::string> Pipeline::getActivePeerIds() const {
+    std::lock_guard<std::mutex> lock(impl_->streamMutex);
+    
+    std::vector<std::string> peerIds;
+    for (const auto& [peerId, info] : impl_->dynamicStreams) {
+        if (info->active) {
+            peerIds.push_back(peerId);
+        }
+    }
+    
+    return peerIds;
+}
+
+StreamTransport Pipeline::getTransport() const {
+    return impl_->config.transport;
+}
+
+// 프로세스 내부 전달: appsink에 도착한 RTP 버퍼를 peer의 appsrc로 그대로 전달
+bool Pipeline::connectAppSource(const std::string& peerId, GstElement* appsrc) {
+    if (!appsrc) {
+        LOG_ERROR("Invalid app source for peer: {}", peerId);
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(impl_->streamMutex);
+    
+    auto it = impl_->dynamicStreams.find(peerId);
+    if (it == impl_->dynamicStreams.end() || !it->second->appsink) {
+        LOG_ERROR("No app sink found for peer: {}", peerId);
+        return false;
+    }
+    
+    // appsrc 참조는 appsink 콜백이 소유하며, appsink 해제 시 함께 해제
+    GstAppSinkCallbacks callbacks = {};
+    callbacks.new_sample = Impl::onAppSinkSample;
+    gst_app_sink_set_callbacks(GST_APP_SINK(it->second->appsink), &callbacks,
+                               gst_object_ref(appsrc), gst_object_unref);
+    
+    LOG_INFO("Connected app source to dynamic stream for peer {}", peerId);
+    return true;
+}
+
+// peer 연결 실패 시: 고아 appsrc로 계속 전달하지 않도록 콜백과 appsrc 참조 해제
+void Pipeline::disconnectAppSource(const std::string& peerId) {
+    std::lock_guard<std::mutex> lock(impl_->streamMutex);
+    
+    auto it = impl_->dynamicStreams.find(peerId);
+    if (it == impl_->dynamicStreams.end() || !it->second->appsink) {
+        return;
+    }
+    
+    GstAppSinkCallbacks callbacks = {};
+    gst_app_sink_set_callbacks(GST_APP_SINK(it->second->appsink), &callbacks,
+                               nullptr, nullptr);
+    
+    LOG_INFO("Disconnected app source from dynamic stream for peer {}", peerId);
+}
+
+// peer 미디어 경로 준비 완료: 다음 버퍼에서 GOP 캐시 또는 새 키프레임으로 시작
+bool Pipeline::primeDynamicStream(const std::string& peerId) {
+    std::lock_guard<std::mutex> lock(impl_->streamMutex);
+    
+    auto it = impl_->dynamicStreams.find(peerId);
+    if (it == impl_->dynamicStreams.end() || !it->second->primer) {
+        LOG_WARNING("No stream to prime for peer: {}", peerId);
+        return false;
+    }
+    
+    auto& primer = it->second->primer;
+    if (!primer->primed) {
+        int64_t expected = 0;
+        primer->requestedAtUs.compare_exchange_strong(expected, steadyNowUs());
+    }
+    
+    return true;
+}
+
+// 공유 파이프라인: peer의 webrtcbin bin을 tee -> queue 뒤에 직접 연결
+bool Pipeline::attachPeerBin(const std::string& peerId, GstElement* peerBin,
+                             CompletionCallback onComplete) {
+    if (!peerBin) {
+        LOG_ERROR("Invalid peer bin for peer: {}", peerId);
+        return false;
+    }
+    
+    std::string teeName;
+    bool armProbe = false;
+    
+    {
+        std::lock_guard<std::mutex> lock(impl_->streamMutex);
+        
+        if (impl_->config.transport != StreamTransport::SHARED_PIPELINE) {
+            LOG_ERROR("Peer bin attach requires shared pipeline transport");
+            return false;
+        }
+        
+        auto it = impl_->dynamicStreams.find(peerId);
+        if (it == impl_->dynamicStreams.end()) {
+            LOG_ERROR("No stream reserved for peer: {}", peerId);
+            return false;
+        }
+        
+        auto info = it->second;
+        if (info->queue) {
+            LOG_WARNING("Peer bin already attached for peer: {}", peerId);
+            return false;
+        }
+        
+        info->peerBin = peerBin;
+        if (!impl_->prepareBranch(info)) {
+            info->peerBin = nullptr;
+            LOG_ERROR("Failed to attach peer bin for peer: {}", peerId);
+            return false;
+        }
+        
+        impl_->acquireEncoder(*info);
+        teeName = Impl::streamTeeName(*info);
+        armProbe = impl_->scheduleBranchOp(teeName, {Impl::BranchOp::ATTACH, info, std::move(onComplete)});
+    }
+    
+    if (armProbe) {
+        impl_->armIdleProbe(teeName);
+    }
+    
+    return true;
+}
+
+GstElement* Pipeline::Impl::branchSink(const DynamicStreamInfo& info) {
+    if (info.peerBin) return info.peerBin;
+    if (info.appsink) return info.appsink;
+    return info.udpsink;
+}
+
+GstFlowReturn Pipeline::Impl::onAppSinkSample(GstAppSink* appsink, gpointer userData) {
+    auto* appsrc = static_cast<GstAppSrc*>(userData);
+    
+    GstSample* sample = gst_app_sink_pull_sample(appsink);
+    if (!sample) {
+        return GST_FLOW_EOS;
+    }
+    
+    // leaky appsrc가 없는 GStreamer에서 peer가 멈추면 대기열이 max-bytes를 넘어도 계속 쌓이므로 여기서 버림
+    const guint64 maxBytes = gst_app_src_get_max_bytes(appsrc);
+    if (maxBytes > 0 && gst_app_src_get_current_level_bytes(appsrc) >= maxBytes) {
+        gst_sample_unref(sample);
+        return GST_FLOW_OK;
+    }
+    
+    // 페이로드 메모리는 참조만 공유하고 메타데이터만 복사
+    // 타임스탬프는 peer 파이프라인 클럭 기준으로 appsrc가 다시 찍음 (do-timestamp)
+    auto retimestamp = [](GstBuffer* buffer) {
+        GstBuffer* outbuf = gst_buffer_copy(buffer);
+        GST_BUFFER_PTS(outbuf) = GST_CLOCK_TIME_NONE;
+        GST_BUFFER_DTS(outbuf) = GST_CLOCK_TIME_NONE;
+        return outbuf;
+    };
+    
+    // 리스트 모드: 한 프레임의 패킷 묶음을 그대로 한 번에 전달
+    if (GstBufferList* list = gst_sample_get_buffer_list(sample)) {
+        guint length = gst_buffer_list_length(list);
+        GstBufferList* outlist = gst_buffer_list_new_sized(length);
+        for (guint i = 0; i < length; ++i) {
+            gst_buffer_list_add(outlist, retimestamp(gst_buffer_list_get(list, i)));
+        }
+        gst_app_src_push_buffer_list(appsrc, outlist);
+    } else if (GstBuffer* buffer = gst_sample_get_buffer(sample)) {
+        gst_app_src_push_buffer(appsrc, retimestamp(buffer));
+    }
+    
+    gst_sample_unref(sample);
+    
+    // peer 쪽 상태(flushing 등)가 메인 파이프라인에 전파되지 않도록 항상 OK 반환
+    return GST_FLOW_OK;
+}
+
+bool Pipeline::start() {
+    if (!impl_->pipeline) {
+        LOG_ERROR("Pipeline not created");
+        return false;
+    }
+    
+    if (impl_->running) {
+        LOG_WARNING("Pipeline already running");
+        return true;
+    }
+    
+    LOG_INFO("Starting pipeline");
+    
+    GstStateChangeReturn ret = gst_element_set_state(
+        impl_->pipeline.get(), GST_STATE_PLAYING);
+    
+    if (ret == GST_STATE_CHANGE_FAILURE) {
+        LOG_ERROR("Failed to start pipeline");
+        return false;
+    }
+    
+    impl_->running = true;
+    
+    if (impl_->watchdog) {
+        Impl* impl = impl_.get();
+        auto branchOf = [](const BranchWatchdog::Target& target) { return static_cast<Impl::Branch>(target.branch); };
+        BranchWatchdog::Callbacks callbacks;
+        callbacks.expectsOutput = [impl, branchOf](const BranchWatchdog::Target& target) {
+            return impl->branchExpectsOutput(target.camera, branchOf(target));
+        };
+        callbacks.isBacklogged = [impl, branchOf](const BranchWatchdog::Target& target) {
+            return impl->branchBacklogged(target.camera, branchOf(target));
+        };
+        callbacks.recover = [impl, branchOf](const BranchWatchdog::Target& target) {
+            return impl->recoverBranch(target.camera, branchOf(target));
+        };
+        callbacks.onStall = [impl](const StallEvent& event) {
+            if (impl->stallCallback) impl->stallCallback(event);
+        };
+        impl_->watchdog->start(std::move(callbacks));
+    }
+    
+    LOG_INFO("Pipeline started successfully");
+    return true;
+}
+
+bool Pipeline::stop() {
+    if (!impl_->pipeline || !impl_->running) {
+        return true;
+    }
+    
+    LOG_INFO("Stopping pipeline");
+    
+    impl_->running = false;
+    
+    // 감시 스레드가 진행 중인 복구를 마칠 때까지 대기 (이후 정지 과정은 감시하지 않음)
+    if (impl_->watchdog) {
+        impl_->watchdog->stop();
+    }
+    
+    using Clock = std::chrono::steady_clock;
+    ShutdownReport report;
+    auto phaseStart = Clock::now();
+    const auto stopStart = phaseStart;
+    auto endPhase = [&phaseStart]() {
+        auto now = Clock::now();
+        double ms = std::chrono::duration<double, std::milli>(now - phaseStart).count();
+        phaseStart = now;
+        return ms;
+    };
+    
+    // 1. 모든 프로브 제거 (CUDA 작업 중단)
+    std::unordered_map<std::string, gulong> probeIds;
+    {
+        std::lock_guard<std::mutex> lock(impl_->stateMutex);
+        probeIds.swap(impl_->probeIds);
+    }
+    for (const auto& [elementName, probeId] : probeIds) {
+        if (auto* element = getElement(elementName)) {
+            if (auto* pad = gst_element_get_static_pad(element, "sink")) {
+                gst_pad_remove_probe(pad, probeId);
+                gst_object_unref(pad);
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(impl_->stateMutex);
+        impl_->probeCallbacks.clear();
+    }
+    if (impl_->latencyTracer) {
+        impl_->latencyTracer->detachAll();
+    }
+    report.probesMs = endPhase();
+    
+    // 2. 모든 동적 스트림 제거 (tee별 IDLE 프로브에서 일괄 분리, 정리 스레드에서 병렬 해제)
+    std::vector<std::string> peerIds;
+    {
+        std::lock_guard<std::mutex> lock(impl_->streamMutex);
+        for (const auto& [peerId, info] : impl_->dynamicStreams) {
+            peerIds.push_back(peerId);
+        }
+    }
+    
+    std::vector<std::future<bool>> removals;
+    for (const auto& peerId : peerIds) {
+        auto done = std::make_shared<std::promise<bool>>();
+        auto future = done->get_future();
+        if (removeDynamicStream(peerId, [done](bool success) { done->set_value(success); })) {
+            removals.push_back(std::move(future));
+        }
+    }
+    
+    // 개별 대기가 아닌 전체 마감 시각 기준으로 대기
+    auto peersDeadline = Clock::now() + kPeerTeardownTimeout;
+    for (auto& removal : removals) {
+        if (removal.wait_until(peersDeadline) != std::future_status::ready) {
+            LOG_WARNING("Timed out waiting for dynamic stream removal");
+            break;
+        }
+    }
+    report.peers = removals.size();
+    report.peersMs = endPhase();
+    
+    // 3. 소스에 EOS 전달 후 모든 카메라의 EOS가 소스 tee에 도달할 때까지만 대기
+    //    (카메라 소스가 정상 종료된 뒤 NULL로 전환, 고정 대기 없음)
+    report.drained = impl_->drainSources(kDrainTimeout);
+    report.drainMs = endPhase();
+    
+    // 4. 파이프라인을 NULL 상태로 전환
+    GstStateChangeReturn ret = gst_element_set_state(impl_->pipeline.get(), GST_STATE_NULL);
+    
+    if (ret == GST_STATE_CHANGE_FAILURE) {
+        LOG_ERROR("Failed to stop pipeline");
+    } else {
+        if (ret == GST_STATE_CHANGE_ASYNC) {
+            GstState state, pending;
+            ret = gst_element_get_state(impl_->pipeline.get(), &state, &pending, GST_SECOND * 2);
+        }
+        
+        if (ret == GST_STATE_CHANGE_SUCCESS) {
+            impl_->currentState = GST_STATE_NULL;
+        } else {
+            LOG_WARNING("Pipeline state change timeout or failure");
+        }
+    }
+    
+    // 5. 버스 감시 해제 및 엘리먼트 참조 해제
+    BusDispatcher::getInstance().detach(impl_->busOwnerId);
+    impl_->busOwnerId = 0;
+    
+    impl_->releaseElements();
+    report.nullMs = endPhase();
+    
+    report.totalMs = std::chrono::duration<double, std::milli>(Clock::now() - stopStart).count();
+    
+    LOG_INFO("Pipeline stopped in {:.0f} ms (probes {:.0f}, peers {:.0f} x{}, drain {:.0f}{}, null {:.0f})",
+             report.totalMs, report.probesMs, report.peersMs, report.peers, report.drainMs,
+             report.drained ? "" : " timed out", report.nullMs);
+    return ret != GST_STATE_CHANGE_FAILURE;
+}
+
+void Pipeline::setStallCallback(StallCallback callback) {
+    impl_->stallCallback = std::move(callback);
+}
+
+std::vector<BranchWatchdog::Health> Pipeline::getBranchHealth() const {
+    if (!impl_->watchdog) return {};
+    return impl_->watchdog->getHealth();
+}
+
+std::vector<Pipeline::CaptureReport> Pipeline::getCaptureReports() const {
+    std::lock_guard<std::mutex> lock(impl_->captureMutex);
+    return impl_->captureReports;
+}
+
+bool Pipeline::setAnalysisEnabled(int cameraIndex, bool enabled) {
+    std::lock_guard<std::mutex> lock(impl_->branchMutex);
+    if (!impl_->running || cameraIndex < 0 || cameraIndex >= static_cast<int>(impl_->analysis.size())) {
+        return false;
+    }
+    if (impl_->config.webrtcConfig.video[cameraIndex].infer.empty()) {
+        return true;
+    }
+
+    auto& control = *impl_->analysis[cameraIndex];
+    if (control.enabled == enabled) {
+        return true;
+    }
+    if (!control.selector) {
+        LOG_WARNING("Analysis on/off for camera {} requires analysis_bypass", cameraIndex);
+        return false;
+    }
+
+    control.enabled = enabled;
+    const uint64_t generation = ++control.generation;
+    if (enabled) {
+        impl_->resumeAnalysis(control, generation);
+    } else {
+        impl_->bypassAnalysis(cameraIndex, control, generation);
+    }
+    LOG_INFO("Analysis for camera {} {}", cameraIndex, enabled ? "resumed" : "bypassed");
+    return true;
+}
+
+bool Pipeline::isAnalysisEnabled(int cameraIndex) const {
+    if (cameraIndex < 0 || cameraIndex >= static_cast<int>(impl_->analysis.size())) {
+        return false;
+    }
+    return impl_->analysis[cameraIndex]->enabled;
+}
+
+int Pipeline::setInferenceInterval(int cameraIndex, int interval) {
+    std::lock_guard<std::mutex> lock(impl_->branchMutex);
+    if (!impl_->running || cameraIndex < 0 || cameraIndex >= static_cast<int>(impl_->analysis.size()) ||
+        interval < 0) {
+        return 0;
+    }
+
+    auto& control = *impl_->analysis[cameraIndex];
+    const bool changed = control.interval != interval;
+    control.interval = interval;
+
+    int applied = impl_->applyInferenceInterval(cameraIndex);
+    if (changed && applied > 0) {
+        LOG_INFO("Inference interval for camera {} set to {} ({} nvinfer)", cameraIndex, interval, applied);
+    }
+    return applied;
+}
+
+int Pipeline::getInferenceInterval(int cameraIndex) const {
+    std::lock_guard<std::mutex> lock(impl_->branchMutex);
+    if (cameraIndex < 0 || cameraIndex >= static_cast<int>(impl_->analysis.size())) {
+        return -1;
+    }
+    return impl_->effectiveInferenceInterval(cameraIndex);
+}
+
+int Pipeline::setRateLimits(int cameraIndex, const RateLimits& limits) {
+    std::lock_guard<std::mutex> lock(impl_->branchMutex);
+    if (!impl_->running || cameraIndex < 0 || cameraIndex >= static_cast<int>(impl_->rates.size())) {
+        return 0;
+    }
+
+    auto& rate = *impl_->rates[cameraIndex];
+    auto& control = *impl_->analysis[cameraIndex];
+    rate.source.fps = limits.sourceFps;
+    for (auto& encoder : rate.encoders) {
+        encoder.fps = limits.encoderFps;
+    }
+
+    const int rateInterval = impl_->inferRateInterval(cameraIndex, limits);
+    const bool changed = rate.limits != limits || control.rateInterval != rateInterval;
+    rate.limits = limits;
+    control.rateInterval = rateInterval;
+
+    int applied = impl_->applyInferenceInterval(cameraIndex);
+    if (changed) {
+        LOG_INFO("Rate limits for camera {}: source {} fps, infer {} fps (interval {}), encoder {} fps "
+                 "(dropped so far: source {}, main {}, sub {})",
+                 cameraIndex, limits.sourceFps, limits.inferFps, impl_->effectiveInferenceInterval(cameraIndex),
+                 limits.encoderFps, rate.source.dropped.load(), rate.encoders[0].dropped.load(),
+                 rate.encoders[1].dropped.load());
+    }
+    return applied;
+}
+
+bool Pipeline::Impl::bypassesAnalysis(int camera) const {
+    return config.webrtcConfig.analysisBypass && !config.webrtcConfig.video[camera].infer.empty();
+}
+
+void Pipeline::Impl::AnalysisControl::release() {
+    // 대기 중인 전환 프로브가 해제된 이 객체를 참조하지 않도록 먼저 제거
+    cancelSwitch();
+    for (GstElement** element : {&inferValve, &bypassValve, &bypassCaps, &selector}) {
+        if (*element) gst_object_unref(*element);
+        *element = nullptr;
+    }
+    for (GstPad** pad : {&inferOutput, &inferPad, &bypassPad}) {
+        if (*pad) gst_object_unref(*pad);
+        *pad = nullptr;
+    }
+}
+
+// 이전 전환 프로브를 새 전환으로 교체 (프로브는 id가 등록된 뒤에만 전환을 수행)
+void Pipeline::Impl::AnalysisControl::armSwitch(GstPadProbeType type, bool resume, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(switchMutex);
+    if (switchProbe) {
+        gst_pad_remove_probe(inferOutput, switchProbe);
+    }
+    switchProbe = gst_pad_add_probe(inferOutput, type, analysisSwitchProbe,
+        new AnalysisSwitch{this, generation, resume},
+        [](gpointer data) { delete static_cast<AnalysisSwitch*>(data); });
+}
+
+void Pipeline::Impl::AnalysisControl::cancelSwitch() {
+    std::lock_guard<std::mutex> lock(switchMutex);
+    if (switchProbe && inferOutput) {
+        gst_pad_remove_probe(inferOutput, switchProbe);
+    }
+    switchProbe = 0;
+}
+
+// selector 입력 패드는 출구 마커/우회 capsfilter와 연결된 요청 패드 (이름 순서에 의존하지 않음)
+void Pipeline::Impl::setupAnalysisControl(int camera) {
+    auto& control = *analysis[camera];
+    GstBin* bin = GST_BIN(pipeline.get());
+
+    control.inferValve = gst_bin_get_by_name(bin, inferValveName(camera).c_str());
+    control.bypassValve = gst_bin_get_by_name(bin, inferBypassName(camera).c_str());
+    control.bypassCaps = gst_bin_get_by_name(bin, inferBypassCapsName(camera).c_str());
+    control.selector = gst_bin_get_by_name(bin, inferSelectorName(camera).c_str());
+
+    if (GstElement* exit = gst_bin_get_by_name(bin, markerName(Branch::INFER, camera, false).c_str())) {
+        control.inferOutput = gst_element_get_static_pad(exit, "src");
+        gst_object_unref(exit);
+    }
+    if (control.inferOutput) {
+        control.inferPad = gst_pad_get_peer(control.inferOutput);
+    }
+    if (control.bypassCaps) {
+        if (GstPad* capsSrc = gst_element_get_static_pad(control.bypassCaps, "src")) {
+            control.bypassPad = gst_pad_get_peer(capsSrc);
+            gst_object_unref(capsSrc);
+        }
+    }
+
+    if (!control.inferValve || !control.bypassValve || !control.selector ||
+        !control.inferPad || !control.bypassPad) {
+        LOG_ERROR("Analysis bypass elements not found for camera {}", camera);
+        control.release();
+        return;
+    }
+
+    g_object_set(control.selector, "active-pad", control.inferPad, nullptr);
+    LOG_DEBUG("Analysis bypass ready for camera {}", camera);
+}
+
+// 분석 끄기: 우회 경로를 먼저 열고 selector 전환 후 추론 입력 차단 (인코더 입력 끊김 없음)
+void Pipeline::Impl::bypassAnalysis(int camera, AnalysisControl& control, uint64_t generation) {
+    GstCaps* caps = gst_pad_get_current_caps(control.inferOutput);
+    if (caps) {
+        control.cancelSwitch();
+        if (!completeBypass(control, caps)) {
+            control.enabled = true;
+        }
+        gst_caps_unref(caps);
+        return;
+    }
+
+    // 추론 출력이 아직 협상 전이면 caps가 정해질 때 전환
+    LOG_DEBUG("Camera {} inference output not negotiated yet, bypass deferred", camera);
+    control.armSwitch(GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, false, generation);
+}
+
+// 분석 켜기: 추론 입력을 열고, 추론 출력 첫 버퍼에서 selector 전환 (추론 재시작 동안 우회 경로 유지)
+void Pipeline::Impl::resumeAnalysis(AnalysisControl& control, uint64_t generation) {
+    g_object_set(control.inferValve, "drop", FALSE, nullptr);
+    control.armSwitch(GST_PAD_PROBE_TYPE_BUFFER, true, generation);
+}
+
+bool Pipeline::Impl::completeBypass(AnalysisControl& control, GstCaps* caps) {
+    // 우회 경로는 시스템 메모리 변환만 가능 (NVMM 등 특수 메모리 출력은 우회 불가)
+    gchar* description = gst_caps_to_string(caps);
+    const bool systemMemory = description && !strstr(description, "memory:");
+    if (!systemMemory) {
+        LOG_ERROR("Cannot bypass analysis: inference output caps {} are not system memory",
+                  description ? description : "unknown");
+    }
+    g_free(description);
+    if (!systemMemory) {
         return false;
     }
-    
-    // 포트 해제
-    impl_->releasePort(info.port);
-    
-    // 스트림 정보 제거
-    impl_->dynamicStreams.erase(it);
-    
-    LOG_INFO("Removed dynamic stream for peer: {}", peerId);
+
+    g_object_set(control.bypassCaps, "caps", caps, nullptr);
+    g_object_set(control.bypassValve, "drop", FALSE, nullptr);
+    g_object_set(control.selector, "active-pad", control.bypassPad, nullptr);
+    g_object_set(control.inferValve, "drop", TRUE, nullptr);
     return true;
 }
 
-// 동적 싱크 제거
-bool Pipeline::Impl::removeDynamicSink(const std::string& peerId) {
-    auto it = dynamicStreams.find(peerId);
-    if (it == dynamicStreams.end()) {
-        return false;
+void Pipeline::Impl::completeResume(AnalysisControl& control) {
+    g_object_set(control.selector, "active-pad", control.inferPad, nullptr);
+    g_object_set(control.bypassValve, "drop", TRUE, nullptr);
+}
+
+// 추론 출구 마커 src (스트리밍 스레드) - 이후 요청으로 무효화된 전환은 그대로 제거
+// 스스로 제거할 때는 switchProbe를 비워 armSwitch/cancelSwitch가 같은 id를 다시 제거하지 않도록 함
+GstPadProbeReturn Pipeline::Impl::analysisSwitchProbe(GstPad*, GstPadProbeInfo* info, gpointer userData) {
+    auto* pending = static_cast<AnalysisSwitch*>(userData);
+    AnalysisControl& control = *pending->control;
+    std::lock_guard<std::mutex> lock(control.switchMutex);
+    if (control.switchProbe != GST_PAD_PROBE_INFO_ID(info)) {
+        return GST_PAD_PROBE_OK;  // 교체/취소되어 제거 중 (제거는 교체한 쪽에서)
     }
-    
-    DynamicStreamInfo& info = it->second;
-    
-    if (!info.active) {
-        return true;
+    if (control.generation.load() != pending->generation) {
+        control.switchProbe = 0;
+        return GST_PAD_PROBE_REMOVE;
     }
-    
-    // Tee 엘리먼트 찾기
-    std::string teeName = "stream_tee_";
-    teeName += (info.type == StreamType::MAIN) ? "main_" : "sub_";
-    teeName += std::to_string(static_cast<int>(info.device));
-    
-    GstElement* tee = gst_bin_get_by_name(GST_BIN(pipeline.get()), teeName.c_str());
-    if (!tee) {
-        LOG_ERROR("Tee element not found: {}", teeName);
-        return false;
+
+    if (pending->resume) {
+        completeResume(control);
+        control.switchProbe = 0;
+        return GST_PAD_PROBE_REMOVE;
     }
-    
-    // 엘리먼트 상태를 NULL로 변경
-    if (info.queue) {
-        gst_element_set_state(info.queue, GST_STATE_NULL);
+
+    GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+    if (GST_EVENT_TYPE(event) != GST_EVENT_CAPS) {
+        return GST_PAD_PROBE_OK;
     }
-    if (info.udpsink) {
-        gst_element_set_state(info.udpsink, GST_STATE_NULL);
+    GstCaps* caps = nullptr;
+    gst_event_parse_caps(event, &caps);
+    if (!completeBypass(control, caps)) {
+        control.enabled = true;
     }
-    
-    // Tee 패드 해제
-    if (info.teepad) {
-        gst_element_release_request_pad(tee, info.teepad);  // 이제 타입이 맞음
-        gst_object_unref(info.teepad);
-        info.teepad = nullptr;
+    control.switchProbe = 0;
+    return GST_PAD_PROBE_REMOVE;
+}
+
+// 디바이스 설정 간격과 프레임레이트 상한 간격 중 더 많이 건너뛰는 값
+int Pipeline::Impl::effectiveInferenceInterval(int camera) const {
+    const auto& control = *analysis[camera];
+    return std::max(control.interval, control.rateInterval);
+}
+
+// 추론 구간의 nvinfer에 interval 적용 (branchMutex 보유 상태, 추론 브랜치 재구성 후 다시 호출)
+int Pipeline::Impl::applyInferenceInterval(int camera) {
+    const int interval = effectiveInferenceInterval(camera);
+    if (interval < 0 || config.webrtcConfig.video[camera].infer.empty()) {
+        return 0;
     }
-    
-    // 파이프라인에서 제거
-    if (info.queue && info.udpsink) {
-        gst_bin_remove_many(GST_BIN(pipeline.get()), info.queue, info.udpsink, nullptr);
+
+    GstBin* bin = GST_BIN(pipeline.get());
+    GstPtr<GstElement> entry(gst_bin_get_by_name(bin, markerName(Branch::INFER, camera, true).c_str()));
+    GstPtr<GstElement> exit(gst_bin_get_by_name(bin, markerName(Branch::INFER, camera, false).c_str()));
+    if (!entry || !exit) {
+        return 0;
     }
-    
-    gst_object_unref(tee);
-    
-    info.active = false;
-    
-    return true;
+
+    std::vector<GstElement*> segment;
+    GstPad* entrySrc = gst_element_get_static_pad(entry.get(), "src");
+    bool found = entrySrc && collectSegment(entrySrc, exit.get(), segment);
+    if (entrySrc) gst_object_unref(entrySrc);
+    if (!found) {
+        return 0;
+    }
+
+    // 재구성된 구간은 bin 하나이므로 하위 엘리먼트까지 검사
+    int applied = 0;
+    std::function<void(GstElement*)> apply = [&](GstElement* element) {
+        if (GST_IS_BIN(element)) {
+            GST_OBJECT_LOCK(element);
+            for (GList* child = GST_BIN_CHILDREN(element); child != nullptr; child = child->next) {
+                apply(GST_ELEMENT(child->data));
+            }
+            GST_OBJECT_UNLOCK(element);
+            return;
+        }
+        GstElementFactory* factory = gst_element_get_factory(element);
+        if (factory && std::strcmp(gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory)), "nvinfer") == 0) {
+            g_object_set(element, "interval", static_cast<guint>(interval), nullptr);
+            applied++;
+        }
+    };
+    for (GstElement* element : segment) {
+        apply(element);
+        gst_object_unref(element);
+    }
+    return applied;
 }
 
-// 포트 할당
-int Pipeline::Impl::allocatePort() {
-    // 동적 스트림용 포트 범위: 5100-5999
-    const int dynamicPortStart = config.basePort + 100;
-    const int dynamicPortEnd = config.basePort + 1000;
-    
-    for (int port = dynamicPortStart; port < dynamicPortEnd; port += 2) {
-        // 예약된 포트 제외
-        if (port >= 7000 && port <= 7199) continue;  // 녹화용
-        
-        // 사용되지 않은 포트 찾기
-        if (usedPorts.find(port) == usedPorts.end()) {
-            usedPorts.insert(port);  // 사용 중으로 표시
-            LOG_DEBUG("Allocated port: {}", port);
-            return port;
+void Pipeline::Impl::RateLimiter::attach(GstPad* target, GstElement* targetEncoder) {
+    static const struct { const char* name; bool perSecond; } kScaled[] = {
+        {"bitrate", true}, {"iframeinterval", false}, {"key-int-max", false}, {"gop-size", false},
+    };
+    
+    detach();
+    if (!target) return;
+    next = GST_CLOCK_TIME_NONE;
+    pad = target;
+    
+    if (targetEncoder) {
+        std::lock_guard<std::mutex> lock(encoderMutex);
+        for (const auto& property : kScaled) {
+            GParamSpec* spec = g_object_class_find_property(G_OBJECT_GET_CLASS(targetEncoder), property.name);
+            if (!spec || G_PARAM_SPEC_VALUE_TYPE(spec) != G_TYPE_UINT || !(spec->flags & G_PARAM_WRITABLE) ||
+                !(spec->flags & GST_PARAM_MUTABLE_PLAYING)) {
+                continue;
+            }
+            guint base = 0;
+            g_object_get(targetEncoder, property.name, &base, nullptr);
+            if (base > 0) {
+                encoderProperties.push_back({property.name, base, property.perSecond});
+            }
+        }
+        if (!encoderProperties.empty()) {
+            encoder = GST_ELEMENT(gst_object_ref(targetEncoder));
         }
     }
-    
-    LOG_ERROR("No available ports in range {}-{}", dynamicPortStart, dynamicPortEnd);
-    LOG_ERROR("Currently used ports: {}", usedPorts.size());
-    return -1;
+    probeId = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, rateLimitProbe, this, nullptr);
 }
 
-// 포트 해제
-void Pipeline::Impl::releasePort(int port) {
-    if (usedPorts.erase(port) > 0) {
-        LOG_DEBUG("Released port: {}", port);
-    } else {
-        LOG_WARNING("Attempted to release unused port: {}", port);
+void Pipeline::Impl::RateLimiter::detach() {
+    if (!pad) return;
+    if (probeId) gst_pad_remove_probe(pad, probeId);
+    {
+        std::lock_guard<std::mutex> lock(encoderMutex);
+        if (encoder) {
+            for (const auto& property : encoderProperties) {
+                g_object_set(encoder, property.name, property.base, nullptr);
+            }
+            gst_object_unref(encoder);
+            encoder = nullptr;
+        }
+        encoderProperties.clear();
     }
+    scaledFps.store(-1, std::memory_order_relaxed);
+    gst_object_unref(pad);
+    pad = nullptr;
+    probeId = 0;
 }
 
-// 스트림 정보 조회
-std::optional<Pipeline::DynamicStreamInfo> 
-Pipeline::getDynamicStreamInfo(const std::string& peerId) const {
-    std::lock_guard<std::mutex> lock(impl_->streamMutex);
-    
-    auto it = impl_->dynamicStreams.find(peerId);
-    if (it != impl_->dynamicStreams.end()) {
-        return it->second;
+// 스트리밍 스레드 (상한이 바뀐 뒤 첫 버퍼) - 인코더는 caps 프레임레이트로 프레임당 예산과 키프레임 주기를
+// 계산하므로 버리는 비율만큼 비트레이트는 올리고 키프레임 간격(프레임 수)은 줄여 초 단위 값을 유지
+void Pipeline::Impl::RateLimiter::scaleEncoder(GstPad* input, int limit) {
+    std::lock_guard<std::mutex> lock(encoderMutex);
+    scaledFps.store(limit, std::memory_order_relaxed);
+    if (!encoder) return;
+    
+    gint num = 0, den = 1;
+    if (GstCaps* caps = gst_pad_get_current_caps(input)) {
+        gst_structure_get_fraction(gst_caps_get_structure(caps, 0), "framerate", &num, &den);
+        gst_caps_unref(caps);
+    }
+    if (num <= 0 || den <= 0) return;  // 가변 프레임레이트는 보정하지 않음
+    
+    const double inputFps = static_cast<double>(num) / den;
+    const double ratio = limit > 0 && limit < inputFps ? inputFps / limit : 1.0;
+    for (const auto& property : encoderProperties) {
+        double value = property.perSecond ? property.base * ratio : property.base / ratio;
+        g_object_set(encoder, property.name,
+                     static_cast<guint>(std::clamp(value, 1.0, static_cast<double>(G_MAXUINT))), nullptr);
     }
-    
-    return std::nullopt;
 }
 
-// 활성 peer ID 목록
-std::vector<std::string> Pipeline::getActivePeerIds() const {
-    std::lock_guard<std::mutex> lock(impl_->streamMutex);
-    
-    std::vector<std::string> peerIds;
-    for (const auto& [peerId, info] : impl_->dynamicStreams) {
-        if (info.active) {
-            peerIds.push_back(peerId);
-        }
+// 스트리밍 스레드 - 상한이 없거나 PTS가 없으면 그대로 통과
+GstPadProbeReturn Pipeline::Impl::rateLimitProbe(GstPad* pad, GstPadProbeInfo* info, gpointer userData) {
+    auto* limiter = static_cast<RateLimiter*>(userData);
+    const int fps = limiter->fps.load(std::memory_order_relaxed);
+    if (limiter->scaledFps.load(std::memory_order_relaxed) != fps) {
+        limiter->scaleEncoder(pad, fps);
     }
-    
-    return peerIds;
+    if (fps <= 0) {
+        limiter->next = GST_CLOCK_TIME_NONE;
+        return GST_PAD_PROBE_OK;
+    }
+    if (passesFrameInterval(limiter->next, GST_SECOND / fps, GST_BUFFER_PTS(GST_PAD_PROBE_INFO_BUFFER(info)))) {
+        return GST_PAD_PROBE_OK;
+    }
+    limiter->dropped.fetch_add(1, std::memory_order_relaxed);
+    return GST_PAD_PROBE_DROP;
 }
 
-bool Pipeline::start() {
-    if (!impl_->pipeline) {
-        LOG_ERROR("Pipeline not created");
-        return false;
+void Pipeline::Impl::setupRateControl(int camera) {
+    auto it = elements.find("video_src_tee" + std::to_string(camera));
+    if (it != elements.end() && it->second) {
+        rates[camera]->source.attach(gst_element_get_static_pad(it->second, "sink"));
     }
-    
-    if (impl_->running) {
-        LOG_WARNING("Pipeline already running");
-        return true;
+    attachEncoderLimiter(camera, StreamType::MAIN);
+    attachEncoderLimiter(camera, StreamType::SECONDARY);
+}
+
+// 라이브 인코더 sink에 설치 (브랜치 안의 videorate가 버린 프레임을 다시 채우지 않도록 인코더 바로 앞)
+// encode_once에서는 메인 인코더가 녹화도 겸하므로 제한하지 않음 (소스 상한만 적용)
+void Pipeline::Impl::attachEncoderLimiter(int camera, StreamType type) {
+    RateLimiter& limiter = rates[camera]->encoders[static_cast<int>(type)];
+    limiter.detach();
+    if (type == StreamType::MAIN && config.webrtcConfig.encodeOnce) {
+        return;
     }
-    
-    LOG_INFO("Starting pipeline");
-    
-    GstStateChangeReturn ret = gst_element_set_state(
-        impl_->pipeline.get(), GST_STATE_PLAYING);
-    
-    if (ret == GST_STATE_CHANGE_FAILURE) {
-        LOG_ERROR("Failed to start pipeline");
-        return false;
+
+    const std::string teeName = (type == StreamType::MAIN ? "stream_tee_main_" : "stream_tee_sub_") +
+                                std::to_string(camera);
+    auto it = teeElements.find(teeName);
+    if (it == teeElements.end()) return;
+
+    GstPad* encoderSrc = findEncoderSrcPad(it->second);
+    if (!encoderSrc) {
+        LOG_DEBUG("No encoder found upstream of {}, encoder rate limit unavailable", teeName);
+        return;
     }
-    
-    impl_->running = true;
-    LOG_INFO("Pipeline started successfully");
-    return true;
+    if (GstElement* encoder = gst_pad_get_parent_element(encoderSrc)) {
+        limiter.attach(gst_element_get_static_pad(encoder, "sink"), encoder);
+        gst_object_unref(encoder);
+    }
+    gst_object_unref(encoderSrc);
 }
 
-bool Pipeline::stop() {
-    if (!impl_->pipeline || !impl_->running) {
-        return true;
+// 추론 입력 프레임레이트(진입 caps, 소스 상한 반영) / 추론 상한 -> nvinfer interval
+int Pipeline::Impl::inferRateInterval(int camera, const RateLimits& limits) {
+    if (limits.inferFps <= 0 || config.webrtcConfig.video[camera].infer.empty()) {
+        return -1;
     }
-    
-    LOG_INFO("Stopping pipeline");
-    
-    impl_->running = false;
-    
-    // 1. 모든 프로브 제거 (CUDA 작업 중단)
-    for (const auto& [elementName, probeId] : impl_->probeIds) {
-        if (auto* element = getElement(elementName)) {
-            if (auto* pad = gst_element_get_static_pad(element, "sink")) {
-                gst_pad_remove_probe(pad, probeId);
-                gst_object_unref(pad);
+
+    double inputFps = 0.0;
+    if (GstElement* entry = gst_bin_get_by_name(GST_BIN(pipeline.get()), markerName(Branch::INFER, camera, true).c_str())) {
+        if (GstPad* pad = gst_element_get_static_pad(entry, "src")) {
+            if (GstCaps* caps = gst_pad_get_current_caps(pad)) {
+                gint num = 0, den = 1;
+                if (gst_structure_get_fraction(gst_caps_get_structure(caps, 0), "framerate", &num, &den) &&
+                    num > 0 && den > 0) {
+                    inputFps = static_cast<double>(num) / den;
+                }
+                gst_caps_unref(caps);
             }
+            gst_object_unref(pad);
         }
+        gst_object_unref(entry);
     }
-    impl_->probeIds.clear();
-    impl_->probeCallbacks.clear();
-    
-    // 2. 모든 동적 스트림 제거
-    std::vector<std::string> peerIds = getActivePeerIds();
-    for (const auto& peerId : peerIds) {
-        removeDynamicStream(peerId);
+    if (limits.sourceFps > 0) {
+        inputFps = inputFps > 0.0 ? std::min(inputFps, static_cast<double>(limits.sourceFps))
+                                  : static_cast<double>(limits.sourceFps);
     }
-    
-    // 3. 파이프라인을 PAUSED 상태로 먼저 전환
-    GstStateChangeReturn ret = gst_element_set_state(
-        impl_->pipeline.get(), GST_STATE_PAUSED);
-    
-    if (ret == GST_STATE_CHANGE_FAILURE) {
-        LOG_ERROR("Failed to pause pipeline");
-    } else {
-        // PAUSED 상태 대기
-        GstState state, pending;
-        gst_element_get_state(impl_->pipeline.get(), &state, &pending, 
-                             GST_SECOND * 5); // 5초 타임아웃
+    if (inputFps <= 0.0) {
+        return -1;  // 협상 전/가변 프레임레이트: 다음 호출에서 다시 계산
     }
+    return std::max(0, static_cast<int>(std::ceil(inputFps / limits.inferFps - 1e-6)) - 1);
+}
+
+// 소스 tee 입력에서 EOS 이벤트를 기다림 (모든 카메라 도달 시 true)
+bool Pipeline::Impl::drainSources(std::chrono::milliseconds timeout) {
+    struct DrainState {
+        std::mutex mutex;
+        std::condition_variable cv;
+        int remaining = 0;
+    };
     
-    // 4. 잠시 대기 (CUDA 작업 완료)
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    auto state = std::make_shared<DrainState>();
+    std::vector<std::pair<GstPad*, gulong>> probes;
     
-    // 5. 파이프라인을 NULL 상태로 전환
-    ret = gst_element_set_state(impl_->pipeline.get(), GST_STATE_NULL);
+    for (int i = 0; i < config.cameras; ++i) {
+        GstPad* pad = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            auto it = elements.find("video_src_tee" + std::to_string(i));
+            if (it != elements.end() && it->second) {
+                pad = gst_element_get_static_pad(it->second, "sink");
+            }
+        }
+        if (!pad) continue;
+        
+        gulong id = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+            [](GstPad*, GstPadProbeInfo* info, gpointer userData) -> GstPadProbeReturn {
+                if (GST_EVENT_TYPE(GST_PAD_PROBE_INFO_EVENT(info)) != GST_EVENT_EOS) {
+                    return GST_PAD_PROBE_OK;
+                }
+                auto& drain = **static_cast<std::shared_ptr<DrainState>*>(userData);
+                {
+                    std::lock_guard<std::mutex> lock(drain.mutex);
+                    --drain.remaining;
+                }
+                drain.cv.notify_all();
+                return GST_PAD_PROBE_OK;  // 제거는 drainSources에서 일괄 처리 (id가 항상 유효)
+            },
+            new std::shared_ptr<DrainState>(state),
+            [](gpointer data) { delete static_cast<std::shared_ptr<DrainState>*>(data); });
+        
+        if (id) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            ++state->remaining;
+            probes.emplace_back(pad, id);
+        } else {
+            gst_object_unref(pad);
+        }
+    }
     
-    if (ret == GST_STATE_CHANGE_FAILURE) {
-        LOG_ERROR("Failed to stop pipeline");
+    if (probes.empty()) {
         return false;
     }
     
-    // 6. NULL 상태 대기
-    GstState state, pending;
-    ret = gst_element_get_state(impl_->pipeline.get(), &state, &pending, 
-                               GST_SECOND * 10); // 10초 타임아웃
+    gst_element_send_event(pipeline.get(), gst_event_new_eos());
     
-    if (ret == GST_STATE_CHANGE_SUCCESS) {
-        impl_->currentState = GST_STATE_NULL;
-        LOG_INFO("Pipeline stopped successfully");
-    } else {
-        LOG_WARNING("Pipeline state change timeout or failure");
+    bool drained;
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        drained = state->cv.wait_for(lock, timeout, [&state]() { return state->remaining <= 0; });
     }
     
-    // 7. 엘리먼트 참조 해제
-    impl_->elements.clear();
-    impl_->teeElements.clear();
+    // 모든 EOS 프로브 정리 (EOS는 패드당 한 번만 지나가므로 남겨 둔 프로브가 다시 집계하지 않음)
+    for (auto& [pad, id] : probes) {
+        gst_pad_remove_probe(pad, id);
+        gst_object_unref(pad);
+    }
     
-    LOG_INFO("Pipeline stopped");
-    return true;
+    if (!drained) {
+        LOG_WARNING("EOS did not reach all camera sources within {} ms", timeout.count());
+    }
+    return drained;
+}
+
+// registerElements/getElement에서 얻은 참조 해제 (teeElements는 elements와 같은 참조를 공유)
+void Pipeline::Impl::releaseElements() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        for (auto& [name, element] : elements) {
+            if (element) gst_object_unref(element);
+        }
+        elements.clear();
+    }
+    teeElements.clear();
+    
+    std::lock_guard<std::mutex> lock(branchMutex);
+    analysis.clear();
+    rates.clear();
 }
 
 bool Pipeline::isRunning() const {
@@ -600,6 +3420,7 @@ bool Pipeline::isRunning() const {
 }
 
 GstElement* Pipeline::getElement(const std::string& name) {
+    std::lock_guard<std::mutex> lock(impl_->stateMutex);
     auto it = impl_->elements.find(name);
     if (it != impl_->elements.end()) {
         return it->second;
@@ -641,6 +3462,16 @@ bool Pipeline::Impl::registerElements() {
         }
     }
     
+    // 소스 tee 등록 (통계용)
+    for (int i = 0; i < config.cameras; ++i) {
+        std::string srcTeeName = "video_src_tee" + std::to_string(i);
+        GstElement* srcTee = gst_bin_get_by_name(GST_BIN(pipeline.get()), srcTeeName.c_str());
+        if (srcTee) {
+            elements[srcTeeName] = srcTee;
+            LOG_DEBUG("Registered source tee: {}", srcTeeName);
+        }
+    }
+    
     // OSD 엘리먼트 등록
     for (int i = 0; i < config.cameras; ++i) {
         std::string osdName = "nvosd_" + std::to_string(i + 1);
@@ -655,61 +3486,201 @@ bool Pipeline::Impl::registerElements() {
     return true;
 }
 
-// OSD 프로브 설정
-bool Pipeline::Impl::setupOsdProbes() {
+// 카메라별 통계 프로브 설정
+// 소스 tee에서 바이트/도착 시각, OSD에서 프레임/처리 시간 집계
+bool Pipeline::Impl::setupStatsProbes() {
+    stats.clear();
+    for (int i = 0; i < config.cameras; ++i) {
+        stats.push_back(std::make_unique<CameraStats>());
+    }
+    
+    for (int i = 0; i < config.cameras; ++i) {
+        attachSourceStatsProbe(i);
+        attachOsdStatsProbe(i);
+    }
+    
+    return true;
+}
+
+void Pipeline::Impl::attachSourceStatsProbe(int camera) {
+    std::string srcTeeName = "video_src_tee" + std::to_string(camera);
+    std::lock_guard<std::mutex> lock(stateMutex);
+    auto it = elements.find(srcTeeName);
+    if (it == elements.end() || !it->second) return;
+    
+    if (GstPad* pad = gst_element_get_static_pad(it->second, "sink")) {
+        probeIds[srcTeeName] = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER,
+            sourceStatsProbe, stats[camera].get(), nullptr);
+        gst_object_unref(pad);
+        LOG_DEBUG("Added source statistics probe for {}", srcTeeName);
+    } else {
+        LOG_ERROR("Failed to get sink pad for {}", srcTeeName);
+    }
+}
+
+// OSD가 없으면 소스 tee에서 프레임 집계 (추론 브랜치 재구성 후 다시 호출)
+void Pipeline::Impl::attachOsdStatsProbe(int camera) {
+    std::string osdName = "nvosd_" + std::to_string(camera + 1);
+    std::lock_guard<std::mutex> lock(stateMutex);
+    auto it = elements.find(osdName);
+    GstElement* osd = it != elements.end() ? it->second : nullptr;
+    
+    stats[camera]->countAtSource.store(osd == nullptr, std::memory_order_relaxed);
+    if (!osd) return;
+    
+    if (GstPad* pad = gst_element_get_static_pad(osd, "sink")) {
+        probeIds[osdName] = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER,
+            osdStatsProbe, stats[camera].get(), nullptr);
+        gst_object_unref(pad);
+        LOG_DEBUG("Added OSD statistics probe for {}", osdName);
+    } else {
+        LOG_ERROR("Failed to get sink pad for {}", osdName);
+    }
+}
+
+GstPadProbeReturn Pipeline::Impl::sourceStatsProbe(GstPad*, GstPadProbeInfo* info, gpointer userData) {
+    auto* camStats = static_cast<CameraStats*>(userData);
+    GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    if (!buffer) return GST_PAD_PROBE_OK;
+    
+    int64_t now = steadyNowUs();
+    camStats->bytes.fetch_add(gst_buffer_get_size(buffer), std::memory_order_relaxed);
+    
+    if (camStats->countAtSource.load(std::memory_order_relaxed)) {
+        camStats->countFrame(now);
+    } else if (GST_BUFFER_PTS_IS_VALID(buffer)) {
+        camStats->stampSource(GST_BUFFER_PTS(buffer), now);
+    }
+    
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn Pipeline::Impl::osdStatsProbe(GstPad*, GstPadProbeInfo* info, gpointer userData) {
+    auto* camStats = static_cast<CameraStats*>(userData);
+    GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    if (!buffer) return GST_PAD_PROBE_OK;
+    
+    int64_t now = steadyNowUs();
+    camStats->countFrame(now);
+    
+    // nvstreammux가 PTS를 다시 찍는 경우 매칭되지 않으므로 별도 집계
+    int64_t sourceUs = GST_BUFFER_PTS_IS_VALID(buffer) ? camStats->findSource(GST_BUFFER_PTS(buffer)) : -1;
+    if (sourceUs > 0 && now >= sourceUs) {
+        camStats->processingUs.record(static_cast<uint64_t>(now - sourceUs));
+    } else {
+        camStats->unmatchedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    return GST_PAD_PROBE_OK;
+}
+
+// 지연 추적 지점 설정
+// 캡처(소스 src 패드) -> 소스 tee -> OSD -> 인코더 출력 -> stream tee -> peer 싱크(prepareBranch)
+void Pipeline::Impl::setupLatencyTracer() {
+    latencyTracer = std::make_unique<LatencyTracer>(config.cameras);
+    
+    auto addPoint = [this](GstElement* element, const char* padName, int camera,
+                           const std::string& name, bool recordsTimeline) {
+        if (!element) return;
+        if (GstPad* pad = gst_element_get_static_pad(element, padName)) {
+            latencyTracer->addMeasurePoint(pad, camera, name, recordsTimeline);
+            gst_object_unref(pad);
+        }
+    };
+    
     for (int i = 0; i < config.cameras; ++i) {
-        std::string elementName = "nvosd_" + std::to_string(i + 1);
-        auto it = elements.find(elementName);
+        std::string cam = "cam" + std::to_string(i);
+        std::string captureName = captureSourceName(i);
+        std::string srcTeeName = "video_src_tee" + std::to_string(i);
+        GstElement* srcTee = elements.count(srcTeeName) ? elements[srcTeeName] : nullptr;
         
-        if (it != elements.end() && it->second) {
-            GstPad* pad = gst_element_get_static_pad(it->second, "sink");
-            if (!pad) {
-                LOG_ERROR("Failed to get sink pad for {}", elementName);
-                continue;
-            }
-            
-            // 통계 데이터 포인터
-            auto& camStats = stats[static_cast<CameraDevice>(i)];
-            
-            gulong probeId = gst_pad_add_probe(pad,
-                GST_PAD_PROBE_TYPE_BUFFER,
-                [](GstPad* pad, GstPadProbeInfo* info, gpointer userData) -> GstPadProbeReturn {
-                    auto* stats = static_cast<Statistics*>(userData);
-                    stats->framesProcessed++;
-                    
-                    // FPS 계산
-                    static auto lastTime = std::chrono::steady_clock::now();
-                    static uint64_t lastFrameCount = 0;
-                    
-                    auto now = std::chrono::steady_clock::now();
-                    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTime);
-                    
-                    if (duration.count() >= 1000) {
-                        stats->currentFps = static_cast<double>(stats->framesProcessed - lastFrameCount) * 1000.0 / duration.count();
-                        lastFrameCount = stats->framesProcessed;
-                        lastTime = now;
-                        
-                        // 평균 FPS 업데이트
-                        if (stats->averageFps == 0) {
-                            stats->averageFps = stats->currentFps;
-                        } else {
-                            stats->averageFps = stats->averageFps * 0.9 + stats->currentFps * 0.1;
-                        }
-                    }
-                    
-                    return GST_PAD_PROBE_OK;
-                },
-                &camStats,
-                nullptr);
-            
-            probeIds[elementName] = probeId;
+        // 캡처 시각: 소스 엘리먼트 출력, 이름이 없으면 소스 tee 입력에서 기록
+        GstElement* capture = gst_bin_get_by_name(GST_BIN(pipeline.get()), captureName.c_str());
+        GstPad* capturePad = capture ? gst_element_get_static_pad(capture, "src")
+                                     : (srcTee ? gst_element_get_static_pad(srcTee, "sink") : nullptr);
+        if (capture) gst_object_unref(capture);
+        
+        if (!capturePad) {
+            LOG_WARNING("No capture point for camera {}, latency tracing disabled for it", i);
+            continue;
+        }
+        latencyTracer->addCapturePoint(capturePad, i);
+        gst_object_unref(capturePad);
+        
+        addPoint(srcTee, "sink", i, cam + ".source_tee", true);
+        addBranchLatencyPoints(i);
+    }
+    
+    LOG_INFO("Latency tracing enabled for {} cameras", config.cameras);
+}
+
+// OSD/인코더/stream tee 지점 (브랜치 재구성 후 다시 호출하면 같은 이름의 지점을 교체)
+void Pipeline::Impl::addBranchLatencyPoints(int camera) {
+    std::string cam = "cam" + std::to_string(camera);
+    
+    std::string osdName = "nvosd_" + std::to_string(camera + 1);
+    auto osdIt = elements.find(osdName);
+    if (osdIt != elements.end() && osdIt->second) {
+        if (GstPad* pad = gst_element_get_static_pad(osdIt->second, "sink")) {
+            latencyTracer->addMeasurePoint(pad, camera, cam + ".osd");
             gst_object_unref(pad);
-            
-            LOG_DEBUG("Added OSD probe for {}", elementName);
         }
     }
     
-    return true;
+    for (const char* type : {"main", "sub"}) {
+        std::string teeName = std::string("stream_tee_") + type + "_" + std::to_string(camera);
+        auto teeIt = teeElements.find(teeName);
+        if (teeIt == teeElements.end()) continue;
+        
+        if (GstPad* encoderPad = findEncoderSrcPad(teeIt->second)) {
+            latencyTracer->addMeasurePoint(encoderPad, camera, cam + "." + type + ".encoder");
+            gst_object_unref(encoderPad);
+        }
+        if (GstPad* pad = gst_element_get_static_pad(teeIt->second, "sink")) {
+            latencyTracer->addMeasurePoint(pad, camera, cam + "." + type + ".stream_tee");
+            gst_object_unref(pad);
+        }
+    }
+}
+
+// stream tee에서 업스트림으로 거슬러 올라가 인코더 src 패드 탐색
+// 재구성된 bin은 ghost 패드의 대상 패드로 내려가서 탐색
+GstPad* Pipeline::Impl::findEncoderSrcPad(GstElement* tee) {
+    GstPad* pad = gst_element_get_static_pad(tee, "sink");
+    
+    for (int hop = 0; pad && hop < 16; ++hop) {
+        GstPad* peer = gst_pad_get_peer(pad);
+        gst_object_unref(pad);
+        pad = nullptr;
+        if (!peer) break;
+        
+        while (GST_IS_GHOST_PAD(peer)) {
+            GstPad* target = gst_ghost_pad_get_target(GST_GHOST_PAD(peer));
+            if (!target) break;
+            gst_object_unref(peer);
+            peer = target;
+        }
+        
+        GstElement* element = gst_pad_get_parent_element(peer);
+        if (!element) {
+            gst_object_unref(peer);
+            break;
+        }
+        
+        const gchar* klass = gst_element_class_get_metadata(
+            GST_ELEMENT_GET_CLASS(element), GST_ELEMENT_METADATA_KLASS);
+        if (klass && std::strstr(klass, "Encoder")) {
+            gst_object_unref(element);
+            return peer;
+        }
+        
+        gst_object_unref(peer);
+        pad = gst_element_get_static_pad(element, "sink");
+        gst_object_unref(element);
+    }
+    
+    if (pad) gst_object_unref(pad);
+    return nullptr;
 }
 
 // 프로브 추가
@@ -727,24 +3698,28 @@ bool Pipeline::addProbe(const std::string& elementName, const std::string& padNa
         return false;
     }
     
-    // 콜백 저장
+    // 콜백 저장 (IDLE 프로브는 설치 중 바로 실행될 수 있으므로 설치는 락 밖에서)
     std::string probeKey = elementName + ":" + padName;
-    impl_->probeCallbacks[probeKey] = callback;
+    ProbeCallback* stored = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(impl_->stateMutex);
+        stored = &(impl_->probeCallbacks[probeKey] = callback);
+    }
     
     gulong probeId = gst_pad_add_probe(pad, probeType,
         Impl::universalProbeCallback,
-        &impl_->probeCallbacks[probeKey],
+        stored,
         nullptr);
+    gst_object_unref(pad);
     
+    std::lock_guard<std::mutex> lock(impl_->stateMutex);
     if (probeId == 0) {
         LOG_ERROR("Failed to add probe to {}:{}", elementName, padName);
         impl_->probeCallbacks.erase(probeKey);
-        gst_object_unref(pad);
         return false;
     }
     
     impl_->probeIds[probeKey] = probeId;
-    gst_object_unref(pad);
     
     LOG_DEBUG("Added probe to {}:{}", elementName, padName);
     return true;
@@ -760,6 +3735,24 @@ GstPadProbeReturn Pipeline::Impl::universalProbeCallback(GstPad* pad,
     return GST_PAD_PROBE_OK;
 }
 
+int Pipeline::getCameraCount() const {
+    return impl_->config.cameras;
+}
+
+int Pipeline::getRecordPort(int cameraIndex) const {
+    return impl_->recordPort(cameraIndex);
+}
+
+std::optional<CameraDevice> Pipeline::resolveCamera(const std::string& source) const {
+    std::unique_lock<std::mutex> lock(impl_->stateMutex);
+    auto index = PipelineText::resolveCamera(source, impl_->config.webrtcConfig.video, impl_->config.cameras);
+    lock.unlock();
+    if (!index) {
+        return std::nullopt;
+    }
+    return cameraDeviceAt(*index);
+}
+
 bool Pipeline::addStream(const std::string& peerId, CameraDevice device, StreamType type) {
     auto port = addDynamicStream(peerId, device, type);
     return port.has_value();
@@ -789,20 +3782,56 @@ std::string Pipeline::getStateString() const {
 }
 
 Pipeline::Statistics Pipeline::getStatistics(CameraDevice device) const {
-    std::lock_guard<std::mutex> lock(impl_->statsMutex);
-    
-    auto it = impl_->stats.find(device);
-    if (it != impl_->stats.end()) {
-        return it->second;
+    size_t index = static_cast<size_t>(device);
+    if (index >= impl_->stats.size()) {
+        return Statistics{};
     }
     
-    return Statistics{};
+    const CameraStats& camStats = *impl_->stats[index];
+    auto interval = camStats.intervalUs.summarize();
+    auto processing = camStats.processingUs.summarize();
+    
+    Statistics result;
+    result.framesProcessed = camStats.frames.load(std::memory_order_relaxed);
+    result.bytesProcessed = camStats.bytes.load(std::memory_order_relaxed);
+    result.currentFps = camStats.currentFps.load(std::memory_order_relaxed);
+    result.averageFps = camStats.averageFps.load(std::memory_order_relaxed);
+    result.jitterMs = camStats.jitterUs.load(std::memory_order_relaxed) / 1000.0;
+    result.frameIntervalP99Ms = interval.p99 / 1000.0;
+    result.processingSamples = processing.count;
+    result.processingMeanMs = processing.mean / 1000.0;
+    result.processingP50Ms = processing.p50 / 1000.0;
+    result.processingP95Ms = processing.p95 / 1000.0;
+    result.processingP99Ms = processing.p99 / 1000.0;
+    result.processingMaxMs = processing.max / 1000.0;
+    result.unmatchedFrames = camStats.unmatchedFrames.load(std::memory_order_relaxed);
+    return result;
 }
 
-// 버스 메시지 핸들러
-gboolean Pipeline::Impl::busCallback(GstBus*, GstMessage* message, gpointer userData) {
-    auto* pipeline = static_cast<Pipeline*>(userData);
+std::vector<Pipeline::LatencyPoint> Pipeline::getLatencyReport() const {
+    std::vector<LatencyPoint> result;
+    if (!impl_->latencyTracer) {
+        return result;
+    }
+    
+    for (const auto& point : impl_->latencyTracer->getReport()) {
+        LatencyPoint entry;
+        entry.name = point.name;
+        entry.samples = point.latencyUs.count;
+        entry.unmatched = point.unmatched;
+        entry.meanMs = point.latencyUs.mean / 1000.0;
+        entry.p50Ms = point.latencyUs.p50 / 1000.0;
+        entry.p95Ms = point.latencyUs.p95 / 1000.0;
+        entry.p99Ms = point.latencyUs.p99 / 1000.0;
+        entry.maxMs = point.latencyUs.max / 1000.0;
+        result.push_back(std::move(entry));
+    }
     
+    return result;
+}
+
+// 버스 메시지 핸들러 (BusDispatcher 스레드에서 호출)
+void Pipeline::Impl::busCallback(GstMessage* message, Pipeline* pipeline) {
     switch (GST_MESSAGE_TYPE(message)) {
         case GST_MESSAGE_ERROR: {
             GError* err;
@@ -858,6 +3887,11 @@ gboolean Pipeline::Impl::busCallback(GstBus*, GstMessage* message, gpointer user
             break;
         }
         
+        case GST_MESSAGE_LATENCY:
+            // 런타임에 추가된 브랜치(공유 모드 webrtcbin 등)의 지연 반영
+            gst_bin_recalculate_latency(GST_BIN(pipeline->impl_->pipeline.get()));
+            break;
+        
         case GST_MESSAGE_ELEMENT: {
             // DeepStream 관련 메시지 처리
             const GstStructure* structure = gst_message_get_structure(message);
@@ -873,6 +3907,4 @@ gboolean Pipeline::Impl::busCallback(GstBus*, GstMessage* message, gpointer user
         default:
             break;
     }
-    
-    return TRUE;
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "video/PipelineProfile.hpp"
+#include "core/Logger.hpp"
+#include <charconv>
+#include <regex>
+#include <sstream>
+
+namespace {
+
+std::string x264(int bitrateKbps, int keyIntMax) {
+    std::stringstream ss;
+    ss << "x264enc tune=zerolatency speed-preset=ultrafast key-int-max=" << keyIntMax
+       << " bitrate=" << bitrateKbps << " ! video/x-h264,profile=constrained-baseline ! "
+       << "rtph264pay pt=96 config-interval=1";
+    return ss.str();
+}
+
+}  // namespace
+
+// record 브랜치 udpsink의 port= 값 (없거나 잘못된 값이면 7000 + 카메라 인덱스)
+int PipelineProfile::recordPort(const Config::VideoConfig& video, int cameraIndex) {
+    static const std::regex portPattern(R"(port=(\d+))");
+    std::smatch match;
+    if (std::regex_search(video.record, match, portPattern)) {
+        const std::string digits = match[1].str();
+        int port = 0;
+        auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), port);
+        if (error == std::errc() && end == digits.data() + digits.size() && port > 0 && port <= 65535) {
+            return port;
+        }
+    }
+    return 7000 + cameraIndex;
+}
+
+bool PipelineProfile::isSupported(const std::string& profile) {
+    return profile == "jetson" || profile == "cpu";
+}
+
+bool PipelineProfile::providesInferenceMeta(const std::string& profile) {
+#ifdef HAVE_DEEPSTREAM
+    return profile == "jetson";
+#else
+    (void)profile;
+    return false;
+#endif
+}
+
+std::vector<std::string> PipelineProfile::requiredPlugins(const std::string& profile) {
+    std::vector<std::string> plugins = {
+        "coreelements", "videoconvert", "videoscale", "videotestsrc", "videorate",
+        "webrtc", "nice", "dtls", "srtp", "rtpmanager", "app", "jpeg"
+    };
+
+    if (profile == "cpu") {
+        plugins.insert(plugins.end(), {"x264", "video4linux2", "udp"});
+    } else {
+        plugins.insert(plugins.end(), {"nvvideoconvert", "nvv4l2h264enc", "nvstreammux", "nvinfer"});
+    }
+
+    return plugins;
+}
+
+void PipelineProfile::apply(Config::WebRTCConfig& config) {
+    if (config.pipelineProfile == "jetson") {
+        return;
+    }
+
+    if (config.pipelineProfile != "cpu") {
+        LOG_WARNING("Unknown pipeline profile '{}', using jetson", config.pipelineProfile);
+        config.pipelineProfile = "jetson";
+        return;
+    }
+
+    // cpu 프로파일은 video 설정이 없는 카메라도 테스트 패턴으로 구성
+    if (static_cast<int>(config.video.size()) < config.deviceCnt) {
+        config.video.resize(config.deviceCnt);
+    }
+    for (int i = 0; i < config.deviceCnt; ++i) {
+        Config::VideoConfig configured = config.video[i];
+        config.video[i] = cpuVideoConfig(config, i);
+        config.video[i].label = configured.label.empty() ? "cam" + std::to_string(i) : configured.label;
+        
+        // 캡처 협상 설정은 cpu_sources(v4l2loopback 등)에도 그대로 적용
+        config.video[i].ioMode = configured.ioMode;
+        config.video[i].poolMinBuffers = configured.poolMinBuffers;
+        config.video[i].poolMaxBuffers = configured.poolMaxBuffers;
+    }
+
+    LOG_INFO("Using CPU pipeline profile for {} cameras", config.deviceCnt);
+}
+
+// jetson 브랜치와 같은 엘리먼트 이름/연결 구조를 가지는 CPU 전용 브랜치
+// 분석 단계는 identity 스텁 (name=nvosd_N) 으로 대체해 통계/분석 프로브 위치를 유지
+Config::VideoConfig PipelineProfile::cpuVideoConfig(const Config::WebRTCConfig& config, int cameraIndex) {
+    const std::string tee = "video_src_tee" + std::to_string(cameraIndex);
+    const bool primary = (cameraIndex == 0);
+    const int width = primary ? 1280 : 640;
+    const int height = primary ? 720 : 480;
+
+    // 소스: cpu_sources에 지정된 파이프라인 조각 (예: v4l2src device=/dev/video10), 없으면 테스트 패턴
+    std::string source = "videotestsrc is-live=true pattern=" + std::string(primary ? "ball" : "smpte");
+    if (cameraIndex < static_cast<int>(config.cpuSources.size()) && !config.cpuSources[cameraIndex].empty()) {
+        source = config.cpuSources[cameraIndex];
+    }
+
+    std::stringstream caps;
+    caps << "video/x-raw,format=I420,width=" << width << ",height=" << height << ",framerate=10/1";
+
+    Config::VideoConfig video;
+
+    video.src = source + " ! videoconvert ! videoscale ! videorate ! " + caps.str() +
+                " ! clockoverlay time-format=\"%D %H:%M:%S\" font-desc=\"Arial, 18\""
+                " ! queue max-size-buffers=5 leaky=downstream ! tee name=" + tee + " ";
+
+    video.record = tee + ". ! queue ! " + x264(primary ? 2000 : 1000, 30) +
+                   " ! queue ! udpsink host=127.0.0.1 port=" +
+                   std::to_string(recordPort(config.video[cameraIndex], cameraIndex)) + " sync=false";
+
+    video.infer = tee + ". ! queue ! videoscale ! video/x-raw,width=640,height=360 ! identity name=nvosd_" +
+                  std::to_string(cameraIndex + 1) + " ! videoscale ! video/x-raw,width=" +
+                  std::to_string(width) + ",height=" + std::to_string(height) + " ! ";
+
+    video.enc = "videoconvert ! " + x264(primary ? 2000 : 1000, 30) + " ! queue max-size-buffers=5 ! ";
+
+    video.enc2 = tee + ". ! queue ! videorate ! video/x-raw,framerate=5/1 ! videoscale ! "
+                 "video/x-raw,width=" + std::to_string(width / 2) + ",height=" + std::to_string(height / 2) +
+                 " ! videoconvert ! " + x264(primary ? 1000 : 300, 15) + " ! queue ! ";
+
+    video.snapshot = tee + ". ! queue ! videoscale ! videorate ! video/x-raw,width=320,height=180,framerate=1/2"
+                     " ! jpegenc ! multifilesink post-messages=true ";
+
+    return video;
+}
@@ -0,0 +1,144 @@
+#include "video/PipelineText.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <regex>
+#include <sstream>
+
+namespace {
+
+std::string lower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+}  // namespace
+
+std::optional<PipelineText::ScaleSpec> PipelineText::parseScalePrefix(const std::string& body) {
+    static const std::regex field(R"(^\s*(width|height|framerate)\s*=\s*(?:\(\w+\))?\s*(\d+)(?:/(\d+))?\s*$)");
+
+    ScaleSpec spec;
+    bool hasScale = false;
+    size_t pos = 0;
+
+    while (true) {
+        size_t link = body.find('!', pos);
+        if (link == std::string::npos) break;
+
+        std::string token = body.substr(pos, link - pos);
+        size_t first = token.find_first_not_of(' ');
+        size_t last = token.find_last_not_of(' ');
+        token = first == std::string::npos ? "" : token.substr(first, last - first + 1);
+
+        if (token == "videoscale") {
+            hasScale = true;
+        } else if (token.rfind("video/x-raw", 0) == 0) {
+            // 일부 필드만 해석된 caps는 접두부에 포함하지 않음 (모든 필드가 유효할 때만 반영)
+            std::stringstream fields(token.substr(11));
+            std::string item;
+            ScaleSpec parsed = spec;
+            bool valid = true;
+            while (std::getline(fields, item, ',')) {
+                if (item.find_first_not_of(' ') == std::string::npos) continue;
+                std::smatch match;
+                if (!std::regex_match(item, match, field)) {
+                    valid = false;
+                    break;
+                }
+                auto value = parseIndex(match[2].str());
+                auto denominator = match[3].matched ? parseIndex(match[3].str()) : std::optional<int>(1);
+                if (!value || !denominator) {
+                    valid = false;
+                    break;
+                }
+                if (match[1] == "width") parsed.width = *value;
+                else if (match[1] == "height") parsed.height = *value;
+                else {
+                    parsed.fpsNum = *value;
+                    parsed.fpsDen = *denominator;
+                }
+            }
+            if (!valid) break;
+            spec = parsed;
+        } else if (token != "queue" && token != "videorate") {
+            break;
+        }
+
+        pos = link + 1;
+        spec.prefixEnd = pos;
+    }
+
+    if (!hasScale || spec.width <= 0 || spec.height <= 0 || spec.fpsDen <= 0 ||
+        body.find_first_not_of(' ', spec.prefixEnd) == std::string::npos) {
+        return std::nullopt;
+    }
+    return spec;
+}
+
+std::string PipelineText::stripRateControl(const std::string& chain) {
+    static const std::regex framerate(R"(,\s*framerate=[^,\s!]+)");
+
+    std::string result;
+    size_t begin = 0;
+    while (begin <= chain.size()) {
+        size_t end = chain.find('!', begin);
+        if (end == std::string::npos) end = chain.size();
+
+        std::string element = chain.substr(begin, end - begin);
+        size_t first = element.find_first_not_of(' ');
+        size_t last = element.find_last_not_of(' ');
+        element = first == std::string::npos ? "" : element.substr(first, last - first + 1);
+
+        std::string factory = element.substr(0, element.find(' '));
+        if (!element.empty() && factory != "videorate") {
+            element = std::regex_replace(element, framerate, "");
+            result += result.empty() ? element : " ! " + element;
+        }
+        begin = end + 1;
+    }
+    return result;
+}
+
+std::optional<int> PipelineText::parseIndex(const std::string& text) {
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        return std::nullopt;
+    }
+    int value = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::optional<int> PipelineText::resolveCamera(const std::string& source,
+                                               const std::vector<Config::VideoConfig>& videos, int cameras) {
+    static const std::regex indexPattern(R"((?:cam|video)(\d+))");
+
+    cameras = std::min(cameras, static_cast<int>(videos.size()));
+    const std::string requested = lower(source);
+
+    std::optional<int> index;
+    std::smatch match;
+    if (auto number = parseIndex(requested)) {
+        index = number;
+    } else if (std::regex_search(requested, match, indexPattern)) {
+        index = parseIndex(match[1].str());
+    } else {
+        // 카메라 label (기본값 RGB, Thermal) 중 가장 긴 일치 항목
+        size_t bestLength = 0;
+        for (int i = 0; i < cameras; ++i) {
+            std::string label = lower(videos[i].label);
+            if (!label.empty() && label.size() > bestLength && requested.find(label) != std::string::npos) {
+                index = i;
+                bestLength = label.size();
+            }
+        }
+    }
+
+    if (!index || *index < 0 || *index >= cameras) {
+        return std::nullopt;
+    }
+    return index;
+}
@@ -0,0 +1,114 @@
+#include "video/RateGovernor.hpp"
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+// 0 = 제한 없음을 가장 빠른 값으로 비교
+int rank(int fps) {
+    return fps > 0 ? fps : INT_MAX;
+}
+
+int fromRank(int value) {
+    return value == INT_MAX ? 0 : value;
+}
+
+// 단계별로 더 빠른(floor) 또는 더 느린(ceiling) 쪽 선택
+Config::RateConfig combine(const Config::RateConfig& a, const Config::RateConfig& b, bool faster) {
+    auto pick = [faster](int x, int y) {
+        return fromRank(faster ? std::max(rank(x), rank(y)) : std::min(rank(x), rank(y)));
+    };
+    Config::RateConfig rates;
+    rates.sourceFps = pick(a.sourceFps, b.sourceFps);
+    rates.inferFps = pick(a.inferFps, b.inferFps);
+    rates.encoderFps = pick(a.encoderFps, b.encoderFps);
+    return rates;
+}
+
+bool isNight(const Config::RateGovernorConfig& config, int hour) {
+    if (config.nightStartHour == config.nightEndHour) {
+        return false;
+    }
+    if (config.nightStartHour < config.nightEndHour) {
+        return hour >= config.nightStartHour && hour < config.nightEndHour;
+    }
+    return hour >= config.nightStartHour || hour < config.nightEndHour;
+}
+
+}  // namespace
+
+std::optional<RateGovernor::Decision> RateGovernor::update(const Config::RateGovernorConfig& config,
+                                                           const Inputs& inputs,
+                                                           std::chrono::steady_clock::time_point now) {
+    Decision target = evaluate(config, inputs);
+
+    if (current_ && *current_ == target) {
+        pending_.reset();
+        return std::nullopt;
+    }
+
+    // 처음 적용, 어느 단계라도 빨라지는 경우, 과열 진입은 바로 적용
+    bool immediate = !current_ || raises(current_->rates, target.rates) || (target.hot && !current_->hot);
+    if (!immediate) {
+        if (!pending_ || *pending_ != target) {
+            pending_ = target;
+            pendingSince_ = now;
+            return std::nullopt;
+        }
+        if (now - pendingSince_ < std::chrono::seconds(config.holdSeconds)) {
+            return std::nullopt;
+        }
+    }
+
+    pending_.reset();
+    current_ = target;
+    return target;
+}
+
+void RateGovernor::reset() {
+    current_.reset();
+    pending_.reset();
+    hot_ = false;
+}
+
+const char* RateGovernor::modeName(Mode mode) {
+    switch (mode) {
+        case Mode::WATCHING: return "watching";
+        case Mode::IDLE: return "idle";
+        case Mode::NIGHT: return "night";
+    }
+    return "unknown";
+}
+
+RateGovernor::Decision RateGovernor::evaluate(const Config::RateGovernorConfig& config, const Inputs& inputs) {
+    // 과열은 hotTempC에서 진입, coolTempC 아래로 내려가야 해제
+    hot_ = hot_ ? inputs.socTempC > config.coolTempC : inputs.socTempC >= config.hotTempC;
+
+    Decision decision;
+    if (inputs.peers > 0) {
+        decision.mode = Mode::WATCHING;
+        decision.rates = config.watching;
+    } else if (isNight(config, inputs.hour)) {
+        decision.mode = Mode::NIGHT;
+        decision.rates = config.night;
+    } else {
+        decision.mode = Mode::IDLE;
+        decision.rates = config.idle;
+    }
+
+    decision.event = inputs.eventArmed;
+    if (decision.event) {
+        decision.rates = combine(decision.rates, config.event, true);
+    }
+    decision.hot = hot_;
+    if (decision.hot) {
+        decision.rates = combine(decision.rates, config.hot, false);
+    }
+    return decision;
+}
+
+bool RateGovernor::raises(const Config::RateConfig& from, const Config::RateConfig& to) {
+    return rank(to.sourceFps) > rank(from.sourceFps) ||
+           rank(to.inferFps) > rank(from.inferFps) ||
+           rank(to.encoderFps) > rank(from.encoderFps);
+}
@@ -0,0 +1,166 @@
+#include "video/SnapshotCache.hpp"
+#include "core/Logger.hpp"
+#include <gst/video/video.h>
+#include <functional>
+#include <string_view>
+
+SnapshotCache::SnapshotCache(int cameras, std::chrono::milliseconds ttl)
+    : ttl_(ttl) {
+    for (int i = 0; i < cameras; ++i) {
+        slots_.push_back(std::make_unique<Slot>());
+    }
+}
+
+SnapshotCache::~SnapshotCache() {
+    for (auto& slot : slots_) {
+        if (slot->gate) gst_object_unref(slot->gate);
+    }
+}
+
+bool SnapshotCache::attach(GstElement* appsink, int camera, GstElement* gate) {
+    if (!appsink || camera < 0 || camera >= static_cast<int>(slots_.size())) {
+        return false;
+    }
+
+    Slot& slot = *slots_[camera];
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        if (slot.gate) gst_object_unref(slot.gate);
+        slot.gate = gate ? GST_ELEMENT(gst_object_ref(gate)) : nullptr;
+    }
+    if (gate) {
+        g_object_set(gate, "drop", TRUE, nullptr);
+    }
+
+    // 최신 한 장만 유지 (처리 지연 시 오래된 샘플은 appsink에서 버림)
+    g_object_set(appsink, "max-buffers", 1, "drop", TRUE, "sync", FALSE, nullptr);
+
+    GstAppSinkCallbacks callbacks = {};
+    callbacks.new_sample = onNewSample;
+    gst_app_sink_set_callbacks(GST_APP_SINK(appsink), &callbacks,
+        new SinkContext{this, camera},
+        [](gpointer data) { delete static_cast<SinkContext*>(data); });
+    slot.attached.store(true, std::memory_order_release);
+
+    LOG_DEBUG("Snapshot cache attached for camera {} ({})", camera, gate ? "on demand" : "continuous");
+    return true;
+}
+
+bool SnapshotCache::isAttached(int camera) const {
+    if (camera < 0 || camera >= static_cast<int>(slots_.size())) {
+        return false;
+    }
+    return slots_[camera]->attached.load(std::memory_order_acquire);
+}
+
+std::optional<SnapshotCache::Snapshot> SnapshotCache::get(int camera) {
+    if (camera < 0 || camera >= static_cast<int>(slots_.size())) {
+        return std::nullopt;
+    }
+
+    Slot& slot = *slots_[camera];
+    std::lock_guard<std::mutex> lock(slot.mutex);
+
+    bool fresh = slot.snapshot.version != 0 && std::chrono::steady_clock::now() - slot.encodedAt < ttl_;
+    if (slot.gate && !fresh) {
+        // 다음 프레임 하나만 통과시키고 도착하면 콜백에서 다시 닫음 (heartbeat 스레드는 기다리지 않음)
+        g_object_set(slot.gate, "drop", FALSE, nullptr);
+    }
+
+    if (slot.snapshot.version == 0) {
+        return std::nullopt;
+    }
+    return slot.snapshot;
+}
+
+uint64_t SnapshotCache::getVersion(int camera) const {
+    if (camera < 0 || camera >= static_cast<int>(slots_.size())) {
+        return 0;
+    }
+    return slots_[camera]->version.load(std::memory_order_acquire);
+}
+
+GstFlowReturn SnapshotCache::onNewSample(GstAppSink* appsink, gpointer userData) {
+    auto* context = static_cast<SinkContext*>(userData);
+    Slot& slot = *context->cache->slots_[context->camera];
+
+    GstSample* sample = gst_app_sink_pull_sample(appsink);
+    if (!sample) {
+        return GST_FLOW_EOS;
+    }
+
+    bool onDemand;
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        onDemand = slot.gate != nullptr;
+    }
+
+    if (onDemand) {
+        {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            if (slot.gate) g_object_set(slot.gate, "drop", TRUE, nullptr);
+        }
+        // snapshot 브랜치 스레드에서 인코딩 (valve가 닫혀 있어 다른 프레임 처리를 막지 않음)
+        context->cache->encodeRaw(slot, sample);
+    } else {
+        GstBuffer* buffer = gst_sample_get_buffer(sample);
+        GstMapInfo map;
+        if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+            context->cache->store(slot, map.data, map.size);
+            gst_buffer_unmap(buffer, &map);
+        }
+    }
+
+    gst_sample_unref(sample);
+    return GST_FLOW_OK;
+}
+
+void SnapshotCache::encodeRaw(Slot& slot, GstSample* sample) {
+    GstCaps* jpegCaps = gst_caps_from_string("image/jpeg");
+    GError* error = nullptr;
+    GstSample* jpeg = gst_video_convert_sample(sample, jpegCaps, GST_SECOND, &error);
+    gst_caps_unref(jpegCaps);
+
+    if (!jpeg) {
+        LOG_ERROR("Failed to encode snapshot: {}", error ? error->message : "unknown error");
+        if (error) g_error_free(error);
+        return;
+    }
+
+    GstBuffer* buffer = gst_sample_get_buffer(jpeg);
+    GstMapInfo map;
+    if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+        store(slot, map.data, map.size);
+        gst_buffer_unmap(buffer, &map);
+    }
+    gst_sample_unref(jpeg);
+}
+
+void SnapshotCache::store(Slot& slot, const guint8* data, size_t size) {
+    if (size == 0) return;
+
+    size_t digest = std::hash<std::string_view>{}(
+        std::string_view(reinterpret_cast<const char*>(data), size));
+
+    // 같은 이미지면 인코딩/버전 갱신 생략
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        if (slot.snapshot.version != 0 && slot.digest == digest && slot.snapshot.jpegBytes == size) {
+            slot.encodedAt = std::chrono::steady_clock::now();
+            return;
+        }
+    }
+
+    gchar* encoded = g_base64_encode(data, size);
+    auto base64 = std::make_shared<const std::string>(encoded);
+    g_free(encoded);
+
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    slot.digest = digest;
+    slot.snapshot.base64 = std::move(base64);
+    slot.snapshot.jpegBytes = size;
+    slot.snapshot.capturedAt = std::chrono::system_clock::now();
+    slot.encodedAt = std::chrono::steady_clock::now();
+    slot.snapshot.version++;
+    slot.version.store(slot.snapshot.version, std::memory_order_release);
+}
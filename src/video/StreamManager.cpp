@@ -21,29 +21,16 @@ bool StreamManager::createStream(const std::string& peerId, const std::string& s
     }
     
     // 소스 파싱
-    CameraDevice device = CameraDevice::RGB;
+    CameraDevice device = pipeline_->resolveCamera(source).value_or(CameraDevice::RGB);
     StreamType type = StreamType::MAIN;
     
-    if (source.find("RGB") != std::string::npos || source.find("rgb") != std::string::npos) {
-        device = CameraDevice::RGB;
-    } else if (source.find("Thermal") != std::string::npos || source.find("thermal") != std::string::npos) {
-        device = CameraDevice::THERMAL;
-    }
-    
     if (source.find("sub") != std::string::npos || source.find("secondary") != std::string::npos) {
         type = StreamType::SECONDARY;
     }
     
-    // 포트 할당
-    int port = allocatePort();
-    if (port < 0) {
-        LOG_ERROR("Failed to allocate port for stream");
-        return false;
-    }
-    
-    // 파이프라인에 스트림 추가
-    if (!pipeline_->addStream(peerId, device, type)) {
-        releasePort(port);
+    // 파이프라인에 스트림 추가 (포트는 Pipeline의 할당기가 관리)
+    auto port = pipeline_->addDynamicStream(peerId, device, type);
+    if (!port) {
         LOG_ERROR("Failed to add stream to pipeline");
         return false;
     }
@@ -53,13 +40,13 @@ bool StreamManager::createStream(const std::string& peerId, const std::string& s
     config.peerId = peerId;
     config.device = device;
     config.type = type;
-    config.port = port;
+    config.port = *port;
     config.active = true;
     
     streams_[peerId] = config;
     
     LOG_INFO("Created stream for peer {} on port {} (device: {}, type: {})", 
-             peerId, port, static_cast<int>(device), static_cast<int>(type));
+             peerId, *port, static_cast<int>(device), static_cast<int>(type));
     
     return true;
 }
@@ -73,12 +60,9 @@ bool StreamManager::removeStream(const std::string& peerId) {
         return false;
     }
     
-    // 파이프라인에서 스트림 제거
+    // 파이프라인에서 스트림 제거 (포트도 함께 해제)
     pipeline_->removeStream(peerId);
     
-    // 포트 해제
-    releasePort(it->second.port);
-    
     // 스트림 정보 제거
     streams_.erase(it);
     
@@ -93,11 +77,9 @@ bool StreamManager::removeAllStreams() {
     
     for (const auto& [peerId, config] : streams_) {
         pipeline_->removeStream(peerId);
-        releasePort(config.port);
     }
     
     streams_.clear();
-    usedPorts_.clear();
     
     return true;
 }
@@ -140,22 +122,3 @@ size_t StreamManager::getActiveStreamCount() const {
     return std::count_if(streams_.begin(), streams_.end(),
         [](const auto& pair) { return pair.second.active; });
 }
-
-int StreamManager::allocatePort() {
-    // 기본 포트부터 시작
-    const int basePort = 5000;
-    const int maxPort = 6000;
-    
-    for (int port = basePort; port < maxPort; port += 2) {
-        if (usedPorts_.find(port) == usedPorts_.end()) {
-            usedPorts_.insert(port);
-            return port;
-        }
-    }
-    
-    return -1;  // 사용 가능한 포트 없음
-}
-
-void StreamManager::releasePort(int port) {
-    usedPorts_.erase(port);
-}
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "video/TimestampOverlay.hpp"
+#include "core/Logger.hpp"
+#include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+// 렌더러 한 번 실행 대기 시간 (초과하면 이번 초는 이전 컴포지션 유지)
+constexpr GstClockTime kRenderTimeout = 200 * GST_MSECOND;
+
+// 렌더러로 복사하지 않는 속성 (이름/부모는 엘리먼트 고유, silent는 렌더러에서 항상 꺼져 있어야 함)
+bool isCopyable(const GParamSpec* pspec) {
+    const guint required = G_PARAM_READABLE | G_PARAM_WRITABLE;
+    if ((pspec->flags & required) != required || (pspec->flags & G_PARAM_CONSTRUCT_ONLY)) {
+        return false;
+    }
+    return std::strcmp(pspec->name, "name") != 0 && std::strcmp(pspec->name, "parent") != 0 &&
+           std::strcmp(pspec->name, "silent") != 0;
+}
+
+}  // namespace
+
+TimestampOverlay::TimestampOverlay(GstElement* clockOverlay, int camera)
+    : source_(GST_ELEMENT(gst_object_ref(clockOverlay))), camera_(camera) {}
+
+TimestampOverlay::~TimestampOverlay() {
+    stopRenderer();
+    if (caps_) gst_caps_unref(caps_);
+    gst_object_unref(source_);
+    LOG_DEBUG("Timestamp overlay for camera {} released ({} renders / {} frames)", camera_, renders_, frames_);
+}
+
+bool TimestampOverlay::install(GstElement* clockOverlay, int camera) {
+    GstPad* pad = gst_element_get_static_pad(clockOverlay, "src");
+    if (!pad) {
+        LOG_WARNING("Clock overlay for camera {} has no src pad", camera);
+        return false;
+    }
+
+    // 텍스트 렌더링은 캐시에서 합성하므로 원래 엘리먼트는 통과만 시킴
+    g_object_set(clockOverlay, "silent", TRUE, nullptr);
+
+    auto* overlay = new std::shared_ptr<TimestampOverlay>(new TimestampOverlay(clockOverlay, camera));
+    gst_pad_add_probe(pad, static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM),
+        frameProbe, overlay,
+        [](gpointer data) { delete static_cast<std::shared_ptr<TimestampOverlay>*>(data); });
+    gst_object_unref(pad);
+
+    LOG_INFO("Cached timestamp overlay enabled for camera {}", camera);
+    return true;
+}
+
+GstPadProbeReturn TimestampOverlay::frameProbe(GstPad* /*pad*/, GstPadProbeInfo* info, gpointer userData) {
+    auto& self = **static_cast<std::shared_ptr<TimestampOverlay>*>(userData);
+
+    if (info->type & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
+        GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+        if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+            GstCaps* caps = nullptr;
+            gst_event_parse_caps(event, &caps);
+            self.setCaps(caps);
+        }
+        return GST_PAD_PROBE_OK;
+    }
+
+    if (!self.caps_) {
+        return GST_PAD_PROBE_OK;
+    }
+
+    // 초가 바뀌었을 때만 텍스트 래스터화
+    if (std::time(nullptr) != self.renderedSecond_ && !self.render()) {
+        self.fallback();
+        return GST_PAD_PROBE_REMOVE;
+    }
+    if (!self.composition_) {
+        return GST_PAD_PROBE_OK;
+    }
+
+    GstBuffer* buffer = gst_buffer_make_writable(GST_PAD_PROBE_INFO_BUFFER(info));
+    GST_PAD_PROBE_INFO_DATA(info) = buffer;
+
+    GstVideoFrame frame;
+    if (gst_video_frame_map(&frame, &self.info_, buffer, GST_MAP_READWRITE)) {
+        gst_video_overlay_composition_blend(self.composition_, &frame);
+        gst_video_frame_unmap(&frame);
+        self.frames_++;
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+// 렌더러 appsink가 컴포지션 메타를 지원한다고 응답 -> clockoverlay가 블렌딩 대신 메타를 붙임
+GstPadProbeReturn TimestampOverlay::allocationProbe(GstPad* /*pad*/, GstPadProbeInfo* info, gpointer /*userData*/) {
+    GstQuery* query = GST_PAD_PROBE_INFO_QUERY(info);
+    if (GST_QUERY_TYPE(query) == GST_QUERY_ALLOCATION &&
+        !gst_query_find_allocation_meta(query, GST_VIDEO_OVERLAY_COMPOSITION_META_API_TYPE, nullptr)) {
+        gst_query_add_allocation_meta(query, GST_VIDEO_OVERLAY_COMPOSITION_META_API_TYPE, nullptr);
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+void TimestampOverlay::setCaps(GstCaps* caps) {
+    if (!caps || (caps_ && gst_caps_is_equal(caps, caps_))) {
+        return;
+    }
+
+    // 해상도/포맷이 바뀌면 컴포지션 위치도 달라지므로 렌더러를 새로 구성
+    stopRenderer();
+    if (caps_) gst_caps_unref(caps_);
+    caps_ = nullptr;
+
+    if (!gst_video_info_from_caps(&info_, caps)) {
+        LOG_WARNING("Unsupported caps for timestamp overlay on camera {}", camera_);
+        return;
+    }
+    caps_ = gst_caps_ref(caps);
+    renderedSecond_ = -1;
+}
+
+bool TimestampOverlay::startRenderer() {
+    renderer_ = gst_pipeline_new(("timestamp_renderer_" + std::to_string(camera_)).c_str());
+    appsrc_ = gst_element_factory_make("appsrc", nullptr);
+    GstElement* text = gst_element_factory_make("clockoverlay", nullptr);
+    appsink_ = gst_element_factory_make("appsink", nullptr);
+
+    if (!renderer_ || !appsrc_ || !text || !appsink_) {
+        LOG_ERROR("Failed to create timestamp renderer for camera {}", camera_);
+        if (appsrc_) gst_object_unref(appsrc_);
+        if (text) gst_object_unref(text);
+        if (appsink_) gst_object_unref(appsink_);
+        if (renderer_) gst_object_unref(renderer_);
+        renderer_ = appsrc_ = appsink_ = nullptr;
+        return false;
+    }
+
+    // 원래 clockoverlay의 글꼴/형식/위치 속성을 그대로 복사
+    guint count = 0;
+    GParamSpec** specs = g_object_class_list_properties(G_OBJECT_GET_CLASS(source_), &count);
+    for (guint i = 0; i < count; ++i) {
+        if (!isCopyable(specs[i])) continue;
+        GValue value = G_VALUE_INIT;
+        g_value_init(&value, specs[i]->value_type);
+        g_object_get_property(G_OBJECT(source_), specs[i]->name, &value);
+        g_object_set_property(G_OBJECT(text), specs[i]->name, &value);
+        g_value_unset(&value);
+    }
+    g_free(specs);
+
+    gst_app_src_set_caps(GST_APP_SRC(appsrc_), caps_);
+    g_object_set(appsrc_, "format", GST_FORMAT_TIME, "block", FALSE, nullptr);
+    g_object_set(appsink_, "sync", FALSE, "async", FALSE, "max-buffers", 1, "drop", TRUE, nullptr);
+
+    gst_bin_add_many(GST_BIN(renderer_), appsrc_, text, appsink_, nullptr);
+    if (!gst_element_link_many(appsrc_, text, appsink_, nullptr)) {
+        LOG_ERROR("Failed to link timestamp renderer for camera {}", camera_);
+        stopRenderer();
+        return false;
+    }
+
+    GstPad* sinkPad = gst_element_get_static_pad(appsink_, "sink");
+    gst_pad_add_probe(sinkPad, GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM, allocationProbe, nullptr, nullptr);
+    gst_object_unref(sinkPad);
+
+    // 빈 캔버스 (메타만 받으므로 내용은 쓰이지 않음)
+    canvas_ = gst_buffer_new_allocate(nullptr, GST_VIDEO_INFO_SIZE(&info_), nullptr);
+    gst_buffer_memset(canvas_, 0, 0, GST_VIDEO_INFO_SIZE(&info_));
+
+    if (gst_element_set_state(renderer_, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        LOG_ERROR("Failed to start timestamp renderer for camera {}", camera_);
+        stopRenderer();
+        return false;
+    }
+    return true;
+}
+
+void TimestampOverlay::stopRenderer() {
+    if (composition_) {
+        gst_video_overlay_composition_unref(composition_);
+        composition_ = nullptr;
+    }
+    if (canvas_) {
+        gst_buffer_unref(canvas_);
+        canvas_ = nullptr;
+    }
+    if (renderer_) {
+        gst_element_set_state(renderer_, GST_STATE_NULL);
+        gst_object_unref(renderer_);
+    }
+    renderer_ = appsrc_ = appsink_ = nullptr;
+}
+
+// 캔버스 한 장을 렌더러에 통과시켜 현재 초의 컴포지션을 받음
+bool TimestampOverlay::render() {
+    if (!renderer_ && !startRenderer()) {
+        return false;
+    }
+
+    std::time_t second = std::time(nullptr);
+    GstBuffer* buffer = gst_buffer_copy(canvas_);
+    GST_BUFFER_PTS(buffer) = renders_ * GST_SECOND;
+    GST_BUFFER_DURATION(buffer) = GST_SECOND;
+    if (gst_app_src_push_buffer(GST_APP_SRC(appsrc_), buffer) != GST_FLOW_OK) {
+        LOG_WARNING("Timestamp renderer for camera {} rejected buffer", camera_);
+        return false;
+    }
+    renders_++;
+
+    GstSample* sample = gst_app_sink_try_pull_sample(GST_APP_SINK(appsink_), kRenderTimeout);
+    if (!sample) {
+        // 일시적인 지연은 이전 컴포지션으로 계속 (다음 초에 재시도)
+        LOG_DEBUG("Timestamp renderer for camera {} timed out", camera_);
+        renderedSecond_ = second;
+        return composition_ != nullptr;
+    }
+
+    GstVideoOverlayCompositionMeta* meta = nullptr;
+    if (GstBuffer* rendered = gst_sample_get_buffer(sample)) {
+        meta = gst_buffer_get_video_overlay_composition_meta(rendered);
+    }
+    if (meta) {
+        if (composition_) gst_video_overlay_composition_unref(composition_);
+        composition_ = gst_video_overlay_composition_ref(meta->overlay);
+        // 렌더 중 초가 넘어갔으면 다음 프레임에서 다시 렌더링
+        renderedSecond_ = second;
+    }
+    gst_sample_unref(sample);
+
+    if (!meta) {
+        LOG_WARNING("Timestamp renderer for camera {} did not attach overlay composition", camera_);
+        return false;
+    }
+    return true;
+}
+
+// 캐시 합성을 쓸 수 없으면 원래 clockoverlay 렌더링으로 복귀
+void TimestampOverlay::fallback() {
+    LOG_WARNING("Falling back to per-frame clock overlay for camera {}", camera_);
+    stopRenderer();
+    g_object_set(source_, "silent", FALSE, nullptr);
+}
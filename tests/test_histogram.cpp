@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "utils/Histogram.hpp"
+#include <thread>
+#include <vector>
+
+TEST(HistogramTest, EmptySummaryIsZero) {
+    Histogram histogram;
+    auto summary = histogram.summarize();
+
+    EXPECT_EQ(summary.count, 0u);
+    EXPECT_EQ(summary.p50, 0u);
+    EXPECT_EQ(summary.max, 0u);
+    EXPECT_EQ(histogram.percentile(0.99), 0u);
+}
+
+TEST(HistogramTest, SmallValuesAreExact) {
+    Histogram histogram;
+    for (uint64_t value = 0; value < 10; ++value) {
+        histogram.record(value);
+    }
+
+    auto summary = histogram.summarize();
+    EXPECT_EQ(summary.count, 10u);
+    EXPECT_DOUBLE_EQ(summary.mean, 4.5);
+    EXPECT_EQ(summary.p50, 5u);
+    EXPECT_EQ(summary.p99, 9u);
+    EXPECT_EQ(summary.max, 9u);
+}
+
+TEST(HistogramTest, PercentileIsBucketUpperBoundWithinRelativeError) {
+    for (uint64_t value : {17ull, 100ull, 1000ull, 33333ull, 1000000ull, 123456789ull}) {
+        Histogram histogram;
+        histogram.record(value);
+
+        uint64_t bound = histogram.percentile(0.5);
+        EXPECT_GE(bound, value) << value;
+        EXPECT_LE(static_cast<double>(bound), static_cast<double>(value) * 1.125) << value;
+    }
+}
+
+TEST(HistogramTest, PercentilesFollowDistribution) {
+    Histogram histogram;
+    for (int i = 0; i < 90; ++i) histogram.record(1000);
+    for (int i = 0; i < 10; ++i) histogram.record(50000);
+
+    auto summary = histogram.summarize();
+    EXPECT_GE(summary.p50, 1000u);
+    EXPECT_LT(summary.p50, 1200u);
+    EXPECT_GE(summary.p95, 50000u);
+    EXPECT_EQ(summary.max, 50000u);
+}
+
+TEST(HistogramTest, HugeValuesGoToLastBucket) {
+    Histogram histogram;
+    histogram.record(UINT64_MAX / 2);
+
+    EXPECT_EQ(histogram.count(), 1u);
+    EXPECT_GT(histogram.percentile(1.0), 0u);
+    EXPECT_EQ(histogram.summarize().max, UINT64_MAX / 2);
+}
+
+TEST(HistogramTest, ResetClearsEverything) {
+    Histogram histogram;
+    histogram.record(42);
+    histogram.reset();
+
+    auto summary = histogram.summarize();
+    EXPECT_EQ(summary.count, 0u);
+    EXPECT_EQ(summary.max, 0u);
+    EXPECT_EQ(histogram.count(), 0u);
+}
+
+TEST(HistogramTest, ConcurrentRecordsAreNotLost) {
+    Histogram histogram;
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 10000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&histogram, t]() {
+            for (int i = 0; i < kPerThread; ++i) {
+                histogram.record(static_cast<uint64_t>(t * 1000 + i % 1000));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    auto summary = histogram.summarize();
+    EXPECT_EQ(summary.count, static_cast<uint64_t>(kThreads * kPerThread));
+    EXPECT_EQ(summary.max, 3999u);
+}
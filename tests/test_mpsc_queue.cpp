@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "utils/MpscQueue.hpp"
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(MpscQueueTest, RoundsCapacityUpToPowerOfTwo) {
+    EXPECT_EQ(MpscQueue<int>(0).capacity(), 2u);
+    EXPECT_EQ(MpscQueue<int>(3).capacity(), 4u);
+    EXPECT_EQ(MpscQueue<int>(8).capacity(), 8u);
+    EXPECT_EQ(MpscQueue<int>(9).capacity(), 16u);
+}
+
+TEST(MpscQueueTest, PopsInPushOrder) {
+    MpscQueue<int> queue(4);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.tryPop());
+
+    EXPECT_TRUE(queue.tryPush(1));
+    EXPECT_TRUE(queue.tryPush(2));
+    EXPECT_FALSE(queue.empty());
+
+    EXPECT_EQ(queue.tryPop(), 1);
+    EXPECT_EQ(queue.tryPop(), 2);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscQueueTest, RejectsPushWhenFull) {
+    MpscQueue<int> queue(4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+
+    EXPECT_EQ(queue.tryPop(), 0);
+    EXPECT_TRUE(queue.tryPush(4));  // 꺼낸 칸은 바로 재사용
+    EXPECT_FALSE(queue.tryPush(5));
+}
+
+TEST(MpscQueueTest, WrapsAroundManyTimes) {
+    MpscQueue<int> queue(2);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(queue.tryPush(i));
+        ASSERT_EQ(queue.tryPop(), i);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscQueueTest, MovesOwnedValues) {
+    MpscQueue<std::unique_ptr<int>> queue(2);
+    EXPECT_TRUE(queue.tryPush(std::make_unique<int>(7)));
+
+    auto value = queue.tryPop();
+    ASSERT_TRUE(value && *value);
+    EXPECT_EQ(**value, 7);
+}
+
+TEST(MpscQueueTest, DeliversEveryValueFromConcurrentProducers) {
+    constexpr int kProducers = 4;
+    constexpr uint64_t kPerProducer = 20000;
+    MpscQueue<uint64_t> queue(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (uint64_t i = 0; i < kPerProducer; ++i) {
+                const uint64_t value = (static_cast<uint64_t>(p) << 32) | i;
+                while (!queue.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // 생산자별 순서 유지, 누락/중복 없음 (실패해도 생산자가 끝나도록 끝까지 꺼냄)
+    std::vector<uint64_t> next(kProducers, 0);
+    uint64_t received = 0;
+    while (received < kProducers * kPerProducer) {
+        auto value = queue.tryPop();
+        if (!value) {
+            std::this_thread::yield();
+            continue;
+        }
+        ++received;
+        const auto producer = static_cast<size_t>(*value >> 32);
+        if (producer >= next.size()) {
+            ADD_FAILURE() << "unknown producer " << producer;
+            continue;
+        }
+        EXPECT_EQ(*value & 0xffffffffu, next[producer]);
+        next[producer] = (*value & 0xffffffffu) + 1;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(queue.empty());
+    for (uint64_t count : next) {
+        EXPECT_EQ(count, kPerProducer);
+    }
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "video/PipelineText.hpp"
+
+namespace {
+
+std::vector<Config::VideoConfig> labeledVideos() {
+    std::vector<Config::VideoConfig> videos(2);
+    videos[0].label = "RGB";
+    videos[1].label = "Thermal";
+    return videos;
+}
+
+}  // namespace
+
+TEST(PipelineTextTest, ParseIndexAcceptsOnlyPlainDigits) {
+    EXPECT_EQ(PipelineText::parseIndex("0"), 0);
+    EXPECT_EQ(PipelineText::parseIndex("17"), 17);
+    EXPECT_FALSE(PipelineText::parseIndex(""));
+    EXPECT_FALSE(PipelineText::parseIndex("-1"));
+    EXPECT_FALSE(PipelineText::parseIndex("+1"));
+    EXPECT_FALSE(PipelineText::parseIndex(" 1"));
+    EXPECT_FALSE(PipelineText::parseIndex("1a"));
+}
+
+TEST(PipelineTextTest, ParseIndexRejectsOverflow) {
+    EXPECT_FALSE(PipelineText::parseIndex("99999999999999999999"));
+    EXPECT_FALSE(PipelineText::parseIndex("2147483648"));
+    EXPECT_EQ(PipelineText::parseIndex("2147483647"), 2147483647);
+}
+
+TEST(PipelineTextTest, ResolvesNumericAndIndexedSources) {
+    auto videos = labeledVideos();
+
+    EXPECT_EQ(PipelineText::resolveCamera("1", videos, 2), 1);
+    EXPECT_EQ(PipelineText::resolveCamera("cam0", videos, 2), 0);
+    EXPECT_EQ(PipelineText::resolveCamera("VIDEO1", videos, 2), 1);
+}
+
+TEST(PipelineTextTest, RejectsOutOfRangeAndOverflowingIndices) {
+    auto videos = labeledVideos();
+
+    EXPECT_FALSE(PipelineText::resolveCamera("2", videos, 2));
+    EXPECT_FALSE(PipelineText::resolveCamera("cam2", videos, 2));
+    EXPECT_FALSE(PipelineText::resolveCamera("99999999999999999999", videos, 2));
+    EXPECT_FALSE(PipelineText::resolveCamera("video99999999999999999999", videos, 2));
+}
+
+TEST(PipelineTextTest, ResolvesLabelsCaseInsensitively) {
+    auto videos = labeledVideos();
+
+    EXPECT_EQ(PipelineText::resolveCamera("rgb", videos, 2), 0);
+    EXPECT_EQ(PipelineText::resolveCamera("thermal_main", videos, 2), 1);
+    EXPECT_FALSE(PipelineText::resolveCamera("depth", videos, 2));
+}
+
+TEST(PipelineTextTest, PrefersLongestMatchingLabel) {
+    std::vector<Config::VideoConfig> videos(2);
+    videos[0].label = "cam";
+    videos[1].label = "camera_left";
+
+    EXPECT_EQ(PipelineText::resolveCamera("camera_left", videos, 2), 1);
+}
+
+TEST(PipelineTextTest, IgnoresCamerasWithoutVideoConfig) {
+    auto videos = labeledVideos();
+
+    // cameras가 video 설정 수보다 커도 설정 밖 인덱스는 거부
+    EXPECT_FALSE(PipelineText::resolveCamera("2", videos, 3));
+    EXPECT_FALSE(PipelineText::resolveCamera("1", videos, 1));
+    EXPECT_FALSE(PipelineText::resolveCamera("thermal", videos, 1));
+}
+
+TEST(PipelineTextTest, StripRateControlRemovesVideorateAndFramerate) {
+    EXPECT_EQ(PipelineText::stripRateControl(
+                  "queue ! videoconvert ! videorate ! video/x-raw,width=640,height=480,framerate=1/2 ! "),
+              "queue ! videoconvert ! video/x-raw,width=640,height=480");
+    EXPECT_EQ(PipelineText::stripRateControl(
+                  "queue ! videorate max-rate=1 ! capsfilter caps=video/x-raw,framerate=(fraction)1/2,format=I420"),
+              "queue ! capsfilter caps=video/x-raw,format=I420");
+}
+
+TEST(PipelineTextTest, StripRateControlKeepsOtherElements) {
+    EXPECT_EQ(PipelineText::stripRateControl("queue leaky=2 ! nvvideoconvert"), "queue leaky=2 ! nvvideoconvert");
+    EXPECT_EQ(PipelineText::stripRateControl("videorate ! "), "");
+    EXPECT_EQ(PipelineText::stripRateControl(""), "");
+}
+
+TEST(PipelineTextTest, ParseScalePrefixReadsResolutionAndFramerate) {
+    const std::string body = "queue ! videoscale ! videorate ! video/x-raw,width=640,height=360,framerate=15/2 ! x264enc";
+    auto spec = PipelineText::parseScalePrefix(body);
+
+    ASSERT_TRUE(spec);
+    EXPECT_EQ(spec->width, 640);
+    EXPECT_EQ(spec->height, 360);
+    EXPECT_EQ(spec->fpsNum, 15);
+    EXPECT_EQ(spec->fpsDen, 2);
+    EXPECT_EQ(body.substr(spec->prefixEnd), " x264enc");
+}
+
+TEST(PipelineTextTest, ParseScalePrefixKeepsSourceRateWithoutFramerate) {
+    auto spec = PipelineText::parseScalePrefix("queue ! videoscale ! video/x-raw, width=(int)320, height=240 ! jpegenc");
+
+    ASSERT_TRUE(spec);
+    EXPECT_EQ(spec->width, 320);
+    EXPECT_EQ(spec->height, 240);
+    EXPECT_EQ(spec->fpsNum, 0);
+    EXPECT_EQ(spec->fpsDen, 1);
+}
+
+TEST(PipelineTextTest, ParseScalePrefixRejectsIncompletePrefixes) {
+    // videoscale 없음, 해상도 없음, 접두부 뒤 엘리먼트 없음, 알 수 없는 caps 필드
+    EXPECT_FALSE(PipelineText::parseScalePrefix("queue ! video/x-raw,width=640,height=360 ! x264enc"));
+    EXPECT_FALSE(PipelineText::parseScalePrefix("queue ! videoscale ! video/x-raw,width=640 ! x264enc"));
+    EXPECT_FALSE(PipelineText::parseScalePrefix("queue ! videoscale ! video/x-raw,width=640,height=360 ! "));
+    EXPECT_FALSE(PipelineText::parseScalePrefix("queue ! videoscale ! video/x-raw,width=640,height=360,format=I420 ! x264enc"));
+}
+
+TEST(PipelineTextTest, ParseScalePrefixRejectsOverflowAndZeroDenominator) {
+    EXPECT_FALSE(PipelineText::parseScalePrefix(
+        "queue ! videoscale ! video/x-raw,width=99999999999999999999,height=360 ! x264enc"));
+    EXPECT_FALSE(PipelineText::parseScalePrefix(
+        "queue ! videoscale ! video/x-raw,width=640,height=360,framerate=15/0 ! x264enc"));
+}
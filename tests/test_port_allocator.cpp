@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "utils/PortAllocator.hpp"
+
+TEST(PortAllocatorTest, AllocatesStepAlignedPortsInOrder) {
+    PortAllocator ports(5100, 5109, 2);
+
+    EXPECT_EQ(ports.allocate(), 5100);
+    EXPECT_EQ(ports.allocate(), 5102);
+    EXPECT_TRUE(ports.isAllocated(5100));
+    EXPECT_FALSE(ports.isAllocated(5101));  // step에 맞지 않는 포트
+    EXPECT_FALSE(ports.isAllocated(5104));
+
+    auto occupancy = ports.getOccupancy();
+    EXPECT_EQ(occupancy.used, 2u);
+    EXPECT_EQ(occupancy.capacity, 5u);
+}
+
+TEST(PortAllocatorTest, ReturnsMinusOneWhenExhausted) {
+    PortAllocator ports(5100, 5103, 2);
+
+    EXPECT_EQ(ports.allocate(), 5100);
+    EXPECT_EQ(ports.allocate(), 5102);
+    EXPECT_EQ(ports.allocate(), -1);
+}
+
+TEST(PortAllocatorTest, ReleasedPortIsReusedLast) {
+    PortAllocator ports(5100, 5105, 2);
+
+    int first = ports.allocate();
+    ASSERT_TRUE(ports.release(first));
+    EXPECT_FALSE(ports.isAllocated(first));
+
+    // 최근 해제된 포트는 프리 리스트 끝으로 (바로 재사용하지 않음)
+    EXPECT_EQ(ports.allocate(), 5102);
+    EXPECT_EQ(ports.allocate(), 5104);
+    EXPECT_EQ(ports.allocate(), first);
+}
+
+TEST(PortAllocatorTest, RejectsInvalidRelease) {
+    PortAllocator ports(5100, 5105, 2);
+
+    EXPECT_FALSE(ports.release(5100));  // 할당되지 않음
+    EXPECT_FALSE(ports.release(5101));  // step 불일치
+    EXPECT_FALSE(ports.release(6000));  // 범위 밖
+
+    int port = ports.allocate();
+    EXPECT_TRUE(ports.release(port));
+    EXPECT_FALSE(ports.release(port));  // 이중 해제
+}
+
+TEST(PortAllocatorTest, ReservedPortsAreNeverAllocated) {
+    PortAllocator ports(5100, 5107, 2);
+    ports.reserve(5102, 5105);
+
+    auto occupancy = ports.getOccupancy();
+    EXPECT_EQ(occupancy.reserved, 2u);
+    EXPECT_EQ(occupancy.capacity, 2u);
+
+    EXPECT_EQ(ports.allocate(), 5100);
+    EXPECT_EQ(ports.allocate(), 5106);
+    EXPECT_EQ(ports.allocate(), -1);
+}
+
+TEST(PortAllocatorTest, ReservingUsedPortTakesEffectOnRelease) {
+    PortAllocator ports(5100, 5103, 2);
+
+    int port = ports.allocate();
+    ports.reserve(port, port);
+    EXPECT_TRUE(ports.isAllocated(port));
+    EXPECT_EQ(ports.getOccupancy().reserved, 0u);
+
+    ASSERT_TRUE(ports.release(port));
+    EXPECT_EQ(ports.getOccupancy().reserved, 1u);
+    EXPECT_EQ(ports.allocate(), 5102);
+    EXPECT_EQ(ports.allocate(), -1);
+}
+
+TEST(PortAllocatorTest, UnreservedPortsBecomeAllocatable) {
+    PortAllocator ports(5100, 5105, 2);
+    ports.reserve(5100, 5100);
+    EXPECT_EQ(ports.getOccupancy().capacity, 2u);
+
+    ports.unreserve(5100, 5100);
+    auto occupancy = ports.getOccupancy();
+    EXPECT_EQ(occupancy.reserved, 0u);
+    EXPECT_EQ(occupancy.capacity, 3u);
+
+    // 예약 해제된 포트는 프리 리스트 끝에서 재사용
+    EXPECT_EQ(ports.allocate(), 5102);
+    EXPECT_EQ(ports.allocate(), 5104);
+    EXPECT_EQ(ports.allocate(), 5100);
+    EXPECT_EQ(ports.allocate(), -1);
+}
+
+TEST(PortAllocatorTest, UnreserveCancelsPendingReservation) {
+    PortAllocator ports(5100, 5103, 2);
+
+    int port = ports.allocate();
+    ports.reserve(port, port);
+    ports.unreserve(port, port);
+
+    ASSERT_TRUE(ports.release(port));
+    EXPECT_EQ(ports.getOccupancy().reserved, 0u);
+    EXPECT_EQ(ports.allocate(), 5102);
+    EXPECT_EQ(ports.allocate(), port);
+}
+
+TEST(PortAllocatorTest, EmptyRangeHasNoCapacity) {
+    PortAllocator ports(5200, 5100, 2);
+
+    EXPECT_EQ(ports.getOccupancy().capacity, 0u);
+    EXPECT_EQ(ports.allocate(), -1);
+}
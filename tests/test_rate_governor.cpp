@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "video/RateGovernor.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+Config::RateConfig rates(int source, int infer, int encoder) {
+    Config::RateConfig config;
+    config.sourceFps = source;
+    config.inferFps = infer;
+    config.encoderFps = encoder;
+    return config;
+}
+
+Config::RateGovernorConfig governorConfig() {
+    Config::RateGovernorConfig config;
+    config.enabled = true;
+    config.watching = rates(0, 15, 0);
+    config.idle = rates(10, 2, 5);
+    config.night = rates(5, 1, 2);
+    config.event = rates(0, 10, 0);
+    config.hot = rates(15, 5, 10);
+    config.nightStartHour = 22;
+    config.nightEndHour = 6;
+    config.hotTempC = 85;
+    config.coolTempC = 78;
+    config.holdSeconds = 30;
+    return config;
+}
+
+RateGovernor::Inputs inputs(int peers, int tempC = 50, bool event = false, int hour = 12) {
+    RateGovernor::Inputs in;
+    in.peers = peers;
+    in.socTempC = tempC;
+    in.eventArmed = event;
+    in.hour = hour;
+    return in;
+}
+
+}  // namespace
+
+TEST(RateGovernorTest, FirstUpdateAppliesImmediately) {
+    RateGovernor governor;
+    EXPECT_FALSE(governor.current());
+
+    auto decision = governor.update(governorConfig(), inputs(0), Clock::now());
+    ASSERT_TRUE(decision);
+    EXPECT_EQ(decision->mode, RateGovernor::Mode::IDLE);
+    EXPECT_EQ(decision->rates, rates(10, 2, 5));
+    ASSERT_TRUE(governor.current());
+    EXPECT_EQ(*governor.current(), *decision);
+}
+
+TEST(RateGovernorTest, UnchangedInputsProduceNoDecision) {
+    RateGovernor governor;
+    auto now = Clock::now();
+    ASSERT_TRUE(governor.update(governorConfig(), inputs(1), now));
+
+    EXPECT_FALSE(governor.update(governorConfig(), inputs(1), now + std::chrono::seconds(1)));
+    EXPECT_FALSE(governor.update(governorConfig(), inputs(2), now + std::chrono::seconds(2)));
+}
+
+TEST(RateGovernorTest, SelectsModeByPeersAndNightHours) {
+    auto config = governorConfig();
+
+    RateGovernor watching;
+    EXPECT_EQ(watching.update(config, inputs(1, 50, false, 23), Clock::now())->mode, RateGovernor::Mode::WATCHING);
+
+    RateGovernor night;
+    auto decision = night.update(config, inputs(0, 50, false, 23), Clock::now());
+    EXPECT_EQ(decision->mode, RateGovernor::Mode::NIGHT);
+    EXPECT_EQ(decision->rates, rates(5, 1, 2));
+
+    // 자정을 넘기는 야간 구간의 끝 시각은 포함하지 않음
+    RateGovernor morning;
+    EXPECT_EQ(morning.update(config, inputs(0, 50, false, 5), Clock::now())->mode, RateGovernor::Mode::NIGHT);
+    RateGovernor day;
+    EXPECT_EQ(day.update(config, inputs(0, 50, false, 6), Clock::now())->mode, RateGovernor::Mode::IDLE);
+
+    config.nightStartHour = config.nightEndHour = 0;
+    RateGovernor noNight;
+    EXPECT_EQ(noNight.update(config, inputs(0, 50, false, 23), Clock::now())->mode, RateGovernor::Mode::IDLE);
+}
+
+TEST(RateGovernorTest, EventRaisesEachStageToItsFloor) {
+    RateGovernor governor;
+    auto decision = governor.update(governorConfig(), inputs(0, 50, true), Clock::now());
+
+    ASSERT_TRUE(decision);
+    EXPECT_TRUE(decision->event);
+    // 단계별로 더 빠른 값 (0 = 제한 없음이 가장 빠름)
+    EXPECT_EQ(decision->rates, rates(0, 10, 0));
+}
+
+TEST(RateGovernorTest, HotCapsEveryStageAndUsesHysteresis) {
+    RateGovernor governor;
+    auto config = governorConfig();
+    auto now = Clock::now();
+
+    auto decision = governor.update(config, inputs(1, 85), now);
+    ASSERT_TRUE(decision);
+    EXPECT_TRUE(decision->hot);
+    EXPECT_EQ(decision->rates, rates(15, 5, 10));  // 제한 없음(0)도 과열 상한으로 낮춤
+
+    // coolTempC보다 높으면 과열 유지
+    EXPECT_FALSE(governor.update(config, inputs(1, 80), now + std::chrono::seconds(1)));
+    EXPECT_TRUE(governor.current()->hot);
+
+    // coolTempC 이하로 내려가면 해제 (빨라지는 결정이므로 즉시)
+    decision = governor.update(config, inputs(1, 78), now + std::chrono::seconds(2));
+    ASSERT_TRUE(decision);
+    EXPECT_FALSE(decision->hot);
+    EXPECT_EQ(decision->rates, rates(0, 15, 0));
+}
+
+TEST(RateGovernorTest, HotEntryIsImmediateEvenWhenLowering) {
+    RateGovernor governor;
+    auto config = governorConfig();
+    auto now = Clock::now();
+    ASSERT_TRUE(governor.update(config, inputs(1), now));
+
+    auto decision = governor.update(config, inputs(1, 90), now + std::chrono::seconds(1));
+    ASSERT_TRUE(decision);
+    EXPECT_TRUE(decision->hot);
+}
+
+TEST(RateGovernorTest, RaisesApplyImmediately) {
+    RateGovernor governor;
+    auto config = governorConfig();
+    auto now = Clock::now();
+    ASSERT_TRUE(governor.update(config, inputs(0), now));
+
+    auto decision = governor.update(config, inputs(1), now + std::chrono::seconds(1));
+    ASSERT_TRUE(decision);
+    EXPECT_EQ(decision->mode, RateGovernor::Mode::WATCHING);
+}
+
+TEST(RateGovernorTest, LoweringWaitsForHoldTime) {
+    RateGovernor governor;
+    auto config = governorConfig();
+    auto now = Clock::now();
+    ASSERT_TRUE(governor.update(config, inputs(1), now));
+
+    // 마지막 시청자가 나가도 hold 동안은 WATCHING 유지
+    EXPECT_FALSE(governor.update(config, inputs(0), now + std::chrono::seconds(1)));
+    EXPECT_FALSE(governor.update(config, inputs(0), now + std::chrono::seconds(30)));
+    EXPECT_EQ(governor.current()->mode, RateGovernor::Mode::WATCHING);
+
+    auto decision = governor.update(config, inputs(0), now + std::chrono::seconds(31));
+    ASSERT_TRUE(decision);
+    EXPECT_EQ(decision->mode, RateGovernor::Mode::IDLE);
+}
+
+TEST(RateGovernorTest, ReturningToCurrentCancelsPendingLowering) {
+    RateGovernor governor;
+    auto config = governorConfig();
+    auto now = Clock::now();
+    ASSERT_TRUE(governor.update(config, inputs(1), now));
+
+    EXPECT_FALSE(governor.update(config, inputs(0), now + std::chrono::seconds(1)));
+    EXPECT_FALSE(governor.update(config, inputs(1), now + std::chrono::seconds(10)));
+
+    // 대기가 취소되었으므로 hold를 처음부터 다시 셈
+    EXPECT_FALSE(governor.update(config, inputs(0), now + std::chrono::seconds(35)));
+    EXPECT_TRUE(governor.update(config, inputs(0), now + std::chrono::seconds(66)));
+}
+
+TEST(RateGovernorTest, ResetForgetsDecisionAndHotState) {
+    RateGovernor governor;
+    auto config = governorConfig();
+    auto now = Clock::now();
+    ASSERT_TRUE(governor.update(config, inputs(1, 90), now));
+
+    governor.reset();
+    EXPECT_FALSE(governor.current());
+
+    // 과열 상태도 초기화되어 coolTempC 위라도 hotTempC 미만이면 과열 아님
+    auto decision = governor.update(config, inputs(1, 80), now + std::chrono::seconds(1));
+    ASSERT_TRUE(decision);
+    EXPECT_FALSE(decision->hot);
+}
+
+TEST(RateGovernorTest, ModeNames) {
+    EXPECT_STREQ(RateGovernor::modeName(RateGovernor::Mode::WATCHING), "watching");
+    EXPECT_STREQ(RateGovernor::modeName(RateGovernor::Mode::IDLE), "idle");
+    EXPECT_STREQ(RateGovernor::modeName(RateGovernor::Mode::NIGHT), "night");
+}
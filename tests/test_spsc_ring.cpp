@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "utils/SpscRing.hpp"
+#include <array>
+#include <thread>
+
+namespace {
+
+// 큰 POD 레코드 (칸에 직접 쓰고 읽는 용도)
+struct Record {
+    uint64_t sequence = 0;
+    std::array<uint64_t, 16> payload{};
+};
+
+}  // namespace
+
+TEST(SpscRingTest, RoundsCapacityUpToPowerOfTwo) {
+    EXPECT_EQ(SpscRing<int>(0).capacity(), 2u);
+    EXPECT_EQ(SpscRing<int>(5).capacity(), 8u);
+    EXPECT_EQ(SpscRing<int>(16).capacity(), 16u);
+}
+
+TEST(SpscRingTest, PublishedSlotsAreReadInOrder) {
+    SpscRing<int> ring(4);
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.front(), nullptr);
+
+    for (int i = 0; i < 3; ++i) {
+        int* slot = ring.acquire();
+        ASSERT_NE(slot, nullptr);
+        *slot = i;
+        ring.publish();
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        const int* slot = ring.front();
+        ASSERT_NE(slot, nullptr);
+        EXPECT_EQ(*slot, i);
+        ring.release();
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, AcquireWithoutPublishIsNotVisible) {
+    SpscRing<int> ring(2);
+
+    int* first = ring.acquire();
+    ASSERT_NE(first, nullptr);
+    *first = 1;
+    EXPECT_EQ(ring.acquire(), first);  // publish 전에는 같은 칸
+    EXPECT_EQ(ring.front(), nullptr);
+
+    ring.publish();
+    ASSERT_NE(ring.front(), nullptr);
+    EXPECT_EQ(*ring.front(), 1);
+}
+
+TEST(SpscRingTest, AcquireFailsWhenFull) {
+    SpscRing<int> ring(2);
+    for (int i = 0; i < 2; ++i) {
+        int* slot = ring.acquire();
+        ASSERT_NE(slot, nullptr);
+        *slot = i;
+        ring.publish();
+    }
+    EXPECT_EQ(ring.acquire(), nullptr);
+
+    ring.release();
+    int* slot = ring.acquire();
+    ASSERT_NE(slot, nullptr);  // 반환된 칸 재사용
+    *slot = 2;
+    ring.publish();
+
+    EXPECT_EQ(*ring.front(), 1);
+    ring.release();
+    EXPECT_EQ(*ring.front(), 2);
+}
+
+TEST(SpscRingTest, TransfersRecordsBetweenThreads) {
+    constexpr uint64_t kRecords = 100000;
+    SpscRing<Record> ring(8);
+
+    std::thread producer([&ring]() {
+        for (uint64_t i = 0; i < kRecords; ++i) {
+            Record* slot;
+            while (!(slot = ring.acquire())) {
+                std::this_thread::yield();
+            }
+            slot->sequence = i;
+            slot->payload.fill(i * 3 + 1);
+            ring.publish();
+        }
+    });
+
+    // 순서와 칸 내용이 publish 시점 그대로인지 확인 (실패해도 생산자가 끝나도록 끝까지 읽음)
+    uint64_t mismatches = 0;
+    for (uint64_t expected = 0; expected < kRecords;) {
+        const Record* slot = ring.front();
+        if (!slot) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (slot->sequence != expected) ++mismatches;
+        for (uint64_t value : slot->payload) {
+            if (value != slot->sequence * 3 + 1) ++mismatches;
+        }
+        ring.release();
+        ++expected;
+    }
+
+    producer.join();
+    EXPECT_EQ(mismatches, 0u);
+    EXPECT_TRUE(ring.empty());
+}